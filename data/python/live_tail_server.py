@@ -0,0 +1,124 @@
+#
+# Local stand-in for CloudWatch Logs StartLiveTail, for exercising the live
+# tail window without an AWS account. Every POST is answered with an
+# application/vnd.amazon.eventstream response: a sessionStart event, then a
+# sessionUpdate every --interval seconds until --duration seconds pass and
+# the session is closed, the client reconnects as it does at the service's
+# session limit.
+#
+# Point the app at it with
+#   IMAWS_LIVE_TAIL_ENDPOINT=http://127.0.0.1:8081 ./gui
+#
+# Any credentials are accepted, signatures are not checked.
+#
+
+import argparse
+import http.server
+import json
+import random
+import struct
+import time
+import uuid
+import zlib
+
+HEADER_STRING = 7
+
+
+def encode_headers(headers):
+    out = b''
+    for name, value in headers.items():
+        name = name.encode()
+        value = value.encode()
+        out += struct.pack('>B', len(name)) + name
+        out += struct.pack('>BH', HEADER_STRING, len(value)) + value
+    return out
+
+
+def encode_message(headers, payload):
+    headers = encode_headers(headers)
+    total = 12 + len(headers) + len(payload) + 4
+    prelude = struct.pack('>II', total, len(headers))
+    prelude += struct.pack('>I', zlib.crc32(prelude))
+    message = prelude + headers + payload
+    return message + struct.pack('>I', zlib.crc32(message))
+
+
+def encode_event(event_type, body):
+    return encode_message({
+        ':message-type': 'event',
+        ':event-type': event_type,
+        ':content-type': 'application/json',
+    }, json.dumps(body).encode())
+
+
+class LiveTailHandler(http.server.BaseHTTPRequestHandler):
+    protocol_version = 'HTTP/1.1'
+    options = None
+
+    def write_chunk(self, data):
+        self.wfile.write(b'%x\r\n%s\r\n' % (len(data), data))
+        self.wfile.flush()
+
+    def do_POST(self):
+        request = json.loads(self.rfile.read(int(self.headers.get('Content-Length', 0))) or b'{}')
+        groups = request.get('logGroupIdentifiers', ['stand-in'])
+        options = self.options
+
+        self.send_response(200)
+        self.send_header('Content-Type', 'application/vnd.amazon.eventstream')
+        self.send_header('Transfer-Encoding', 'chunked')
+        self.send_header('x-amzn-RequestId', str(uuid.uuid4()))
+        self.end_headers()
+
+        try:
+            self.write_chunk(encode_event('sessionStart', {
+                'requestId': str(uuid.uuid4()),
+                'sessionId': str(uuid.uuid4()),
+                'logGroupIdentifiers': groups,
+            }))
+
+            sequence = 0
+            deadline = time.monotonic() + options.duration
+            while time.monotonic() < deadline:
+                now = int(time.time() * 1000)
+                results = []
+                for _ in range(options.rate):
+                    sequence += 1
+                    results.append({
+                        'logStreamName': f'stream-{random.randrange(options.streams)}',
+                        'logGroupIdentifier': groups[0],
+                        'message': f'request {sequence} took {random.randrange(1, 500)} ms',
+                        'timestamp': now,
+                        'ingestionTime': now,
+                    })
+
+                self.write_chunk(encode_event('sessionUpdate', {
+                    'sessionMetadata': {'sampled': options.sampled},
+                    'sessionResults': results,
+                }))
+                time.sleep(options.interval)
+
+            self.write_chunk(b'')
+        except (BrokenPipeError, ConnectionResetError):
+            pass
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Local stand-in for StartLiveTail')
+    parser.add_argument('--host', default='127.0.0.1')
+    parser.add_argument('--port', type=int, default=8081)
+    parser.add_argument('--rate', type=int, default=100, help='events per update, the service sends at most 500')
+    parser.add_argument('--interval', type=float, default=1.0, help='seconds between updates')
+    parser.add_argument('--duration', type=float, default=60.0, help='seconds before a session is closed')
+    parser.add_argument('--streams', type=int, default=4)
+    parser.add_argument('--sampled', action='store_true', help='mark every update as sampled')
+    LiveTailHandler.options = parser.parse_args()
+
+    options = LiveTailHandler.options
+    with http.server.ThreadingHTTPServer((options.host, options.port), LiveTailHandler) as httpd:
+        print(f'Live tail stand-in on http://{options.host}:{options.port}')
+        httpd.serve_forever()
+
+
+if __name__ == '__main__':
+    main()
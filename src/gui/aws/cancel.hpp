@@ -0,0 +1,15 @@
+#pragma once
+
+#include <aws/core/AmazonWebServiceRequest.h>
+
+#include <stop_token>
+
+namespace sm {
+    /// @brief Abort the HTTP transfer of @p request as soon as @p stop is signalled,
+    ///        rather than waiting for the response to finish downloading.
+    inline void bindStopToken(Aws::AmazonWebServiceRequest& request, std::stop_token stop) {
+        request.SetContinueRequestHandler([stop = std::move(stop)](const Aws::Http::HttpRequest *) {
+            return !stop.stop_requested();
+        });
+    }
+}
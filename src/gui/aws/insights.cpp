@@ -0,0 +1,480 @@
+#include "insights.hpp"
+
+#include "gui/aws/cancel.hpp"
+#include "gui/aws/shared_client.hpp"
+#include "util/executor.hpp"
+
+#include <aws/logs/CloudWatchLogsErrors.h>
+#include <aws/logs/model/GetQueryResultsRequest.h>
+#include <aws/logs/model/StopQueryRequest.h>
+
+#include <algorithm>
+#include <regex>
+
+using ImAws::InsightsQuery;
+
+namespace {
+    using CloudWatchLogsClient = Aws::CloudWatchLogs::CloudWatchLogsClient;
+    using CloudWatchLogsClientConfiguration = Aws::CloudWatchLogs::CloudWatchLogsClientConfiguration;
+    using CloudWatchLogsErrors = Aws::CloudWatchLogs::CloudWatchLogsErrors;
+    using QueryStatus = Aws::CloudWatchLogs::Model::QueryStatus;
+    using ResultRow = Aws::Vector<Aws::CloudWatchLogs::Model::ResultField>;
+
+    // Every row carries a @ptr that identifies its log event, it is not shown as a column.
+    constexpr std::string_view kPointerField = "@ptr";
+
+    std::string_view getPointer(const ResultRow& row) {
+        for (const auto& field : row) {
+            if (field.GetField() == kPointerField) {
+                return field.GetValue();
+            }
+        }
+        return {};
+    }
+
+    void appendRows(sm::ColumnTable& table, const std::vector<ResultRow>& rows) {
+        std::vector<sm::ColumnCell> cells;
+        for (const ResultRow& row : rows) {
+            cells.clear();
+            for (const auto& field : row) {
+                if (field.GetField() != kPointerField) {
+                    cells.push_back(sm::ColumnCell{field.GetField(), field.GetValue()});
+                }
+            }
+
+            table.appendRow(cells);
+        }
+    }
+
+    bool isFinished(QueryStatus status) {
+        switch (status) {
+        case QueryStatus::Complete:
+        case QueryStatus::Failed:
+        case QueryStatus::Cancelled:
+        case QueryStatus::Timeout:
+        case QueryStatus::Unknown:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // StartQuery fails with LimitExceededException while the account is at its concurrent query quota.
+    bool isQuotaError(const Aws::CloudWatchLogs::CloudWatchLogsError& error) {
+        return error.GetErrorType() == CloudWatchLogsErrors::LIMIT_EXCEEDED || ImAws::isThrottle(error);
+    }
+
+    bool isNewestFirst(const Aws::String& query) {
+        static const std::regex kSortDescending{R"(\|\s*sort\s+@timestamp\s+desc)", std::regex::icase};
+        return std::regex_search(query, kSortDescending);
+    }
+
+    //
+    // Rows of shorter windows only add up to the rows of the whole range
+    // when each row is a log event and the rows are sorted by time. An
+    // aggregation gives a partial row per window, bin() buckets on a
+    // window edge show up twice, dedup and limit apply per window, and any
+    // other sort order interleaves across windows.
+    //
+    bool isSplittable(const Aws::String& query) {
+        static const std::regex kCommand{R"((^|\|)\s*(stats|dedup|limit)\b)", std::regex::icase};
+        static const std::regex kSort{R"((^|\|)\s*sort\s+([^|]*))", std::regex::icase};
+        static const std::regex kTimestampOrder{R"(\s*@timestamp(\s+(asc|desc))?\s*)", std::regex::icase};
+
+        if (std::regex_search(query, kCommand)) {
+            return false;
+        }
+
+        bool isSorted = false;
+        for (auto it = std::sregex_iterator(query.begin(), query.end(), kSort); it != std::sregex_iterator(); ++it) {
+            if (!std::regex_match((*it)[2].str(), kTimestampOrder)) {
+                return false;
+            }
+            isSorted = true;
+        }
+
+        return isSorted;
+    }
+}
+
+InsightsQuery::~InsightsQuery() {
+    cancel();
+}
+
+InsightsQuery::Window *InsightsQuery::findWindow(uint32_t id) {
+    auto it = std::find_if(mWindows.begin(), mWindows.end(), [&](const Window& window) {
+        return window.id == id;
+    });
+
+    return it != mWindows.end() ? &*it : nullptr;
+}
+
+void InsightsQuery::addWindows(size_t at, int64_t start, int64_t end, int parts) {
+    int64_t duration = end - start + 1;
+    parts = static_cast<int>(std::min<int64_t>(parts, duration));
+
+    std::vector<Window> windows;
+    for (int i = 0; i < parts; ++i) {
+        windows.push_back(Window {
+            .id = mNextWindowId++,
+            .start = start + duration * i / parts,
+            .end = start + duration * (i + 1) / parts - 1,
+        });
+    }
+
+    if (mNewestFirst) {
+        std::reverse(windows.begin(), windows.end());
+    }
+
+    mWindows.insert(mWindows.begin() + static_cast<ptrdiff_t>(at), std::make_move_iterator(windows.begin()), std::make_move_iterator(windows.end()));
+}
+
+void InsightsQuery::submitStart(Window& window) {
+    window.status = WindowStatus::eStarting;
+
+    Aws::CloudWatchLogs::Model::StartQueryRequest request = mRequest;
+    request.SetStartTime(window.start);
+    request.SetEndTime(window.end);
+
+    sm::Executor::get().submit(mStop, [shared = mShared, generation = mGeneration, id = window.id, context = mContext, request = std::move(request)](std::stop_token stop) mutable {
+        sm::bindStopToken(request, stop);
+
+        auto client = createClient<CloudWatchLogsClient, CloudWatchLogsClientConfiguration>(context);
+        auto outcome = client.StartQuery(request);
+        if (stop.stop_requested()) {
+            //
+            // The query was cancelled while StartQuery was in flight, the
+            // UI no longer knows about it, so stop it from here.
+            //
+            if (outcome.IsSuccess()) {
+                Aws::CloudWatchLogs::Model::StopQueryRequest stopRequest;
+                stopRequest.SetQueryId(outcome.GetResult().GetQueryId());
+                client.StopQuery(stopRequest);
+            }
+            return;
+        }
+
+        Response response{generation, id};
+        if (outcome.IsSuccess()) {
+            response.queryId = outcome.GetResult().GetQueryId();
+            response.status = QueryStatus::Scheduled;
+        } else {
+            response.error = outcome.GetError();
+        }
+
+        shared->responses.enqueue(std::move(response));
+    });
+}
+
+void InsightsQuery::submitPoll(Window& window) {
+    window.isPolling = true;
+
+    Aws::CloudWatchLogs::Model::GetQueryResultsRequest request;
+    request.SetQueryId(window.queryId);
+
+    sm::Executor::get().submit(mStop, [shared = mShared, generation = mGeneration, id = window.id, context = mContext, request = std::move(request), from = window.rowCount, lastPointer = window.lastPointer](std::stop_token stop) mutable {
+        sm::bindStopToken(request, stop);
+
+        auto client = createClient<CloudWatchLogsClient, CloudWatchLogsClientConfiguration>(context);
+        auto outcome = client.GetQueryResults(request);
+        if (stop.stop_requested()) {
+            return;
+        }
+
+        Response response{generation, id};
+        if (!outcome.IsSuccess()) {
+            response.error = outcome.GetError();
+            shared->responses.enqueue(std::move(response));
+            return;
+        }
+
+        const auto& result = outcome.GetResult();
+        const auto& rows = result.GetResults();
+
+        const auto& statistics = result.GetStatistics();
+        response.status = result.GetStatus();
+        response.stats = InsightsQueryStats {
+            .recordsMatched = statistics.GetRecordsMatched(),
+            .recordsScanned = statistics.GetRecordsScanned(),
+            .bytesScanned = statistics.GetBytesScanned(),
+        };
+
+        //
+        // Only the rows past those already held are sent back, unless the
+        // last held row is no longer where it was.
+        //
+        if (from > rows.size() || (from > 0 && getPointer(rows[from - 1]) != lastPointer)) {
+            from = 0;
+            response.replace = true;
+        }
+
+        response.rows.assign(rows.begin() + static_cast<ptrdiff_t>(from), rows.end());
+
+        shared->responses.enqueue(std::move(response));
+    });
+}
+
+void InsightsQuery::submitStop(const Aws::String& queryId) {
+    //
+    // A query left running keeps scanning, and is billed, until it times
+    // out, so tell the service to stop it.
+    //
+    Aws::CloudWatchLogs::Model::StopQueryRequest request;
+    request.SetQueryId(queryId);
+
+    sm::Executor::get().submit([context = mContext, request = std::move(request)](std::stop_token) {
+        auto client = createClient<CloudWatchLogsClient, CloudWatchLogsClientConfiguration>(context);
+        client.StopQuery(request);
+    });
+}
+
+bool InsightsQuery::split(size_t index, sm::ColumnTable& table) {
+    Window& window = mWindows[index];
+    if (window.end <= window.start) {
+        return false;
+    }
+
+    if (window.status == WindowStatus::eRunning) {
+        submitStop(window.queryId);
+    }
+
+    if (index == mHead) {
+        table.truncate(mHeadBase);
+        mTruncated = true;
+    }
+
+    int64_t start = window.start;
+    int64_t end = window.end;
+    mWindows.erase(mWindows.begin() + static_cast<ptrdiff_t>(index));
+    addWindows(index, start, end, kSplitFactor);
+    return true;
+}
+
+void InsightsQuery::advanceHead(sm::ColumnTable& table) {
+    while (mHead < mWindows.size() && mWindows[mHead].status == WindowStatus::eDone) {
+        mHead += 1;
+        mHeadBase = table.getRowCount();
+
+        if (mHead < mWindows.size()) {
+            Window& head = mWindows[mHead];
+            appendRows(table, head.buffered);
+            head.buffered = std::vector<Row>{};
+        }
+    }
+
+    if (mHead == mWindows.size()) {
+        mIsActive = false;
+    }
+}
+
+void InsightsQuery::fail(CwlError error) {
+    mError = std::move(error);
+    cancel();
+}
+
+void InsightsQuery::onResponse(Response response, sm::ColumnTable& table) {
+    Window *window = findWindow(response.window);
+    if (window == nullptr) {
+        // The window was split while this was in flight.
+        if (!response.queryId.empty()) {
+            submitStop(response.queryId);
+        }
+        return;
+    }
+
+    auto now = Clock::now();
+
+    if (response.error.has_value()) {
+        //
+        // Failing cancels every window, so a transient error on one of them
+        // is retried like a throttle. The quota frees up as other windows
+        // finish, those are retried for as long as it takes.
+        //
+        bool isQuota = isQuotaError(*response.error);
+        if (!isQuota && !(isRetryable(*response.error) && window->failedAttempts < kMaxRetryAttempts)) {
+            fail(std::move(*response.error));
+            return;
+        }
+
+        if (window->status == WindowStatus::eStarting) {
+            if (isQuota) {
+                mConcurrency.onThrottle();
+            }
+            window->status = WindowStatus::ePending;
+        }
+
+        window->isPolling = false;
+        window->pollAt = now + sm::AdaptiveLimit::getBackoff(window->failedAttempts);
+        window->failedAttempts += 1;
+        return;
+    }
+
+    window->failedAttempts = 0;
+
+    if (window->status == WindowStatus::eStarting) {
+        mConcurrency.onSuccess();
+        window->status = WindowStatus::eRunning;
+        window->queryId = std::move(response.queryId);
+        window->pollAt = now + kPollInterval;
+        return;
+    }
+
+    window->isPolling = false;
+    window->stats = response.stats;
+    window->pollAt = now + kPollInterval;
+
+    size_t index = static_cast<size_t>(window - mWindows.data());
+    bool isHead = index == mHead;
+
+    if (response.replace) {
+        if (isHead) {
+            table.truncate(mHeadBase);
+            mTruncated = true;
+        } else {
+            window->buffered.clear();
+        }
+        window->rowCount = 0;
+    }
+
+    if (!response.rows.empty()) {
+        window->rowCount += response.rows.size();
+        window->lastPointer = getPointer(response.rows.back());
+
+        if (isHead) {
+            appendRows(table, response.rows);
+        } else {
+            std::move(response.rows.begin(), response.rows.end(), std::back_inserter(window->buffered));
+        }
+    }
+
+    //
+    // A window at the row cap is missing rows, split it without waiting
+    // for it to finish. The same goes for one the service gave up on. A
+    // query that can't be split runs to the end and reports it instead.
+    //
+    bool isCapped = window->rowCount >= kMaxRows;
+    if ((isCapped || response.status == QueryStatus::Timeout) && mIsSplittable && split(index, table)) {
+        return;
+    }
+
+    if (response.status == QueryStatus::Complete || (isCapped && isFinished(response.status))) {
+        if (isCapped) {
+            mTruncatedWindows += 1;
+        }
+
+        window->status = WindowStatus::eDone;
+        advanceHead(table);
+        return;
+    }
+
+    if (isFinished(response.status)) {
+        Aws::String status = Aws::CloudWatchLogs::Model::QueryStatusMapper::GetNameForQueryStatus(response.status);
+        fail(CwlError{CloudWatchLogsErrors::UNKNOWN, "QueryNotComplete", "Logs Insights query ended with status " + status, false});
+    }
+}
+
+void InsightsQuery::schedule() {
+    auto now = Clock::now();
+
+    size_t running = std::count_if(mWindows.begin(), mWindows.end(), [](const Window& window) {
+        return window.status == WindowStatus::eStarting || window.status == WindowStatus::eRunning;
+    });
+
+    //
+    // Windows are visited in stitch order so the quota goes to the rows
+    // that will be shown first.
+    //
+    for (Window& window : mWindows) {
+        if (window.pollAt > now) {
+            continue;
+        }
+
+        if (window.status == WindowStatus::ePending && running < mConcurrency.getLimit()) {
+            submitStart(window);
+            running += 1;
+        } else if (window.status == WindowStatus::eRunning && !window.isPolling) {
+            submitPoll(window);
+        }
+    }
+}
+
+void InsightsQuery::start(ClientContext context, Aws::CloudWatchLogs::Model::StartQueryRequest request, int64_t start, int64_t end) {
+    cancel();
+
+    mContext = std::move(context);
+    mRequest = std::move(request);
+    mNewestFirst = isNewestFirst(mRequest.GetQueryString());
+    mIsSplittable = isSplittable(mRequest.GetQueryString());
+
+    mWindows.clear();
+    mHead = 0;
+    mHeadBase = 0;
+    mTruncatedWindows = 0;
+    mConcurrency = sm::AdaptiveLimit{kInitialConcurrency, kMaxConcurrency};
+    mError.reset();
+
+    addWindows(0, start, end, 1);
+    mIsActive = true;
+}
+
+void InsightsQuery::cancel() {
+    for (const Window& window : mWindows) {
+        if (window.status == WindowStatus::eRunning) {
+            submitStop(window.queryId);
+        }
+    }
+
+    mStop.request_stop();
+    mStop = std::stop_source{};
+    mGeneration += 1;
+
+    for (Window& window : mWindows) {
+        if (window.status != WindowStatus::eDone) {
+            window.status = WindowStatus::eDone;
+            window.buffered.clear();
+        }
+    }
+
+    mIsActive = false;
+}
+
+bool InsightsQuery::poll(sm::ColumnTable& table) {
+    mTruncated = false;
+
+    Response response;
+    while (mShared->responses.try_dequeue(response)) {
+        if (response.generation == mGeneration) {
+            onResponse(std::move(response), table);
+        } else if (!response.queryId.empty()) {
+            // Started by a query that has since been cancelled.
+            submitStop(response.queryId);
+        }
+    }
+
+    if (mIsActive) {
+        schedule();
+    }
+
+    return mTruncated;
+}
+
+ImAws::InsightsQueryStats InsightsQuery::getStats() const {
+    InsightsQueryStats stats{};
+    for (const Window& window : mWindows) {
+        stats.recordsMatched += window.stats.recordsMatched;
+        stats.recordsScanned += window.stats.recordsScanned;
+        stats.bytesScanned += window.stats.bytesScanned;
+
+        if (window.status == WindowStatus::eStarting || window.status == WindowStatus::eRunning) {
+            stats.runningWindows += 1;
+        } else if (window.status == WindowStatus::eDone) {
+            stats.finishedWindows += 1;
+        }
+    }
+
+    stats.windowCount = mWindows.size();
+    stats.truncatedWindows = mTruncatedWindows;
+    stats.concurrency = mConcurrency.getLimit();
+    stats.isSplittable = mIsSplittable;
+    return stats;
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include "gui/aws/window.hpp"
+#include "util/adaptive_limit.hpp"
+#include "util/column_table.hpp"
+
+#include <aws/logs/CloudWatchLogsClient.h>
+#include <aws/logs/model/QueryStatus.h>
+#include <aws/logs/model/ResultField.h>
+#include <aws/logs/model/StartQueryRequest.h>
+
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <vector>
+#include <concurrentqueue.h>
+
+namespace ImAws {
+    struct InsightsQueryStats {
+        double recordsMatched;
+        double recordsScanned;
+        double bytesScanned;
+
+        size_t windowCount; // sub-queries the time range is currently split into
+        size_t runningWindows;
+        size_t finishedWindows;
+        size_t truncatedWindows; // hit the row cap and could not be split
+        size_t concurrency;
+        bool isSplittable; // the query can be run as several shorter windows
+    };
+
+    //
+    // Runs one Logs Insights query and collects its rows into a ColumnTable.
+    //
+    // A query that reaches the row cap, or times out, has its time window
+    // split into kSplitFactor shorter windows. Each is run as its own
+    // query, concurrently up to the account's concurrent query quota.
+    // Only queries whose rows are the events themselves sorted by
+    // @timestamp are split, the rows of an aggregation, a dedup or a limit
+    // can't be put back together from shorter windows. Other queries
+    // report the truncation, or fail on a timeout, instead. The
+    // windows are kept in the order their rows belong in, newest first for
+    // queries sorted by descending @timestamp and oldest first otherwise.
+    // The first window still open streams its rows into the table as they
+    // arrive. Later windows buffer theirs until every window before them
+    // has finished.
+    //
+    // Polling is driven from poll() on the UI thread. At most one
+    // GetQueryResults is in flight per window, and each asks only for the
+    // rows past those already held. GetQueryResults always returns every
+    // row so far, and a sorted query may reorder them between polls. Each
+    // poll also sends the @ptr of the last row held. If that row has moved,
+    // the worker sends back the whole set.
+    //
+    class InsightsQuery {
+        using CwlError = Aws::CloudWatchLogs::CloudWatchLogsError;
+        using QueryStatus = Aws::CloudWatchLogs::Model::QueryStatus;
+        using Row = Aws::Vector<Aws::CloudWatchLogs::Model::ResultField>;
+        using Clock = std::chrono::steady_clock;
+
+        enum class WindowStatus {
+            ePending,
+            eStarting,
+            eRunning,
+            eDone,
+        };
+
+        struct Window {
+            uint32_t id;
+            int64_t start; // unix epoch seconds, inclusive
+            int64_t end; // unix epoch seconds, inclusive
+
+            WindowStatus status = WindowStatus::ePending;
+            Aws::String queryId;
+            bool isPolling = false;
+            int failedAttempts = 0; // in a row
+            Clock::time_point pollAt;
+
+            size_t rowCount = 0;
+            std::string lastPointer;
+            std::vector<Row> buffered; // rows held until this window reaches the head
+            InsightsQueryStats stats{};
+        };
+
+        struct Response {
+            uint32_t generation;
+            uint32_t window;
+            std::optional<CwlError> error;
+            Aws::String queryId; // set by the StartQuery response only
+            QueryStatus status = QueryStatus::NOT_SET;
+            bool replace = false; // rows start from the first row rather than after those held
+            std::vector<Row> rows;
+            InsightsQueryStats stats{};
+        };
+
+        struct State {
+            moodycamel::ConcurrentQueue<Response> responses;
+        };
+
+        static constexpr std::chrono::seconds kPollInterval{1};
+
+        // Rows a single query returns at most.
+        static constexpr size_t kMaxRows = 10'000;
+        static constexpr int kSplitFactor = 4;
+
+        // Default account quota for concurrent Logs Insights queries.
+        static constexpr size_t kInitialConcurrency = 10;
+        static constexpr size_t kMaxConcurrency = 30;
+
+        std::shared_ptr<State> mShared = std::make_shared<State>();
+        std::stop_source mStop;
+        uint32_t mGeneration = 0;
+
+        ClientContext mContext;
+        Aws::CloudWatchLogs::Model::StartQueryRequest mRequest;
+        bool mNewestFirst = false;
+        bool mIsSplittable = false;
+
+        std::vector<Window> mWindows; // in the order their rows are stitched
+        size_t mHead = 0; // first window whose rows are not all in the table
+        size_t mHeadBase = 0; // table row where the head window's rows begin
+        uint32_t mNextWindowId = 0;
+        bool mIsActive = false;
+        bool mTruncated = false; // rows were removed from the table since the last poll
+        size_t mTruncatedWindows = 0;
+
+        sm::AdaptiveLimit mConcurrency{kInitialConcurrency, kMaxConcurrency};
+
+        std::optional<CwlError> mError;
+
+        Window *findWindow(uint32_t id);
+        void addWindows(size_t at, int64_t start, int64_t end, int parts);
+
+        void submitStart(Window& window);
+        void submitPoll(Window& window);
+        void submitStop(const Aws::String& queryId);
+
+        bool split(size_t index, sm::ColumnTable& table);
+        void advanceHead(sm::ColumnTable& table);
+        void onResponse(Response response, sm::ColumnTable& table);
+        void schedule();
+        void fail(CwlError error);
+
+    public:
+        ~InsightsQuery();
+
+        /// @param start Unix epoch seconds, inclusive.
+        /// @param end Unix epoch seconds, inclusive.
+        void start(ClientContext context, Aws::CloudWatchLogs::Model::StartQueryRequest request, int64_t start, int64_t end);
+
+        /// @brief Stop polling and ask the service to stop every running query.
+        void cancel();
+
+        /// @brief Apply finished responses to @p table, then start and poll
+        ///        queries that are due.
+        /// @return True if rows were removed from @p table.
+        bool poll(sm::ColumnTable& table);
+
+        bool isWorking() const { return mIsActive; }
+        InsightsQueryStats getStats() const;
+
+        bool hasError() const { return mError.has_value(); }
+        const CwlError& error() const { return mError.value(); }
+        void clear() { mError.reset(); }
+    };
+}
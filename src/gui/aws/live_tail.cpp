@@ -0,0 +1,257 @@
+#include "live_tail.hpp"
+
+#include "gui/aws/cancel.hpp"
+#include "gui/aws/shared_client.hpp"
+#include "util/adaptive_limit.hpp"
+
+#include <aws/logs/model/StartLiveTailHandler.h>
+#include <aws/logs/model/StartLiveTailRequest.h>
+
+#include <condition_variable>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+using ImAws::LiveTail;
+
+namespace {
+    using CloudWatchLogsClient = Aws::CloudWatchLogs::CloudWatchLogsClient;
+    using CloudWatchLogsClientConfiguration = Aws::CloudWatchLogs::CloudWatchLogsClientConfiguration;
+
+    // StartLiveTail rejects ARNs that end in a wildcard, DescribeLogGroups returns them that way.
+    std::string trimArnWildcard(std::string arn) {
+        if (arn.ends_with(":*")) {
+            arn.resize(arn.size() - 2);
+        }
+        return arn;
+    }
+
+    //
+    // Sends sessions to another endpoint, such as the local stand-in in
+    // data/python/live_tail_server.py.
+    //
+    void configureEndpoint(CloudWatchLogsClientConfiguration& config) {
+        if (const char *endpoint = std::getenv("IMAWS_LIVE_TAIL_ENDPOINT")) {
+            config.endpointOverride = endpoint;
+        }
+    }
+
+    struct SessionThread {
+        std::jthread thread;
+        std::shared_ptr<const std::atomic<bool>> isFinished;
+    };
+
+    struct SessionRegistry {
+        std::mutex mutex;
+        std::vector<SessionThread> threads;
+        bool isShutdown = false;
+    };
+
+    SessionRegistry& getRegistry() {
+        static SessionRegistry registry;
+        return registry;
+    }
+}
+
+LiveTail::~LiveTail() {
+    cancel();
+}
+
+void LiveTail::start(ClientContext context, std::string logGroupArn, std::string filterPattern) {
+    cancel();
+
+    mShared = std::make_shared<State>(kRingCapacity);
+    mStreams.clear();
+    mError.reset();
+
+    Aws::CloudWatchLogs::Model::StartLiveTailRequest request;
+    request.SetLogGroupIdentifiers({trimArnWildcard(std::move(logGroupArn))});
+    if (!filterPattern.empty()) {
+        request.SetLogEventFilterPattern(filterPattern);
+    }
+
+    std::jthread thread([shared = mShared, context = std::move(context), request = std::move(request)](std::stop_token stop) mutable {
+        auto client = createClient<CloudWatchLogsClient, CloudWatchLogsClientConfiguration>(context, configureEndpoint);
+
+        std::unordered_map<std::string, uint32_t> streamIds;
+        Update pending;
+
+        std::atomic<bool> isStarted{false}; // a session started since the last attempt
+
+        Aws::CloudWatchLogs::Model::StartLiveTailHandler handler;
+        handler.SetLiveTailSessionStartCallback([&](const Aws::CloudWatchLogs::Model::LiveTailSessionStart&) {
+            shared->isConnected.store(true);
+            isStarted.store(true);
+        });
+
+        handler.SetLiveTailSessionUpdateCallback([&](const Aws::CloudWatchLogs::Model::LiveTailSessionUpdate& update) {
+            const auto& results = update.GetSessionResults();
+
+            bool isSampled = update.GetSessionMetadata().GetSampled();
+            shared->isSampled.store(isSampled, std::memory_order_relaxed);
+            if (isSampled) {
+                shared->sampledUpdates.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            if (results.empty()) {
+                return;
+            }
+
+            shared->receivedEvents.fetch_add(results.size(), std::memory_order_relaxed);
+
+            size_t bytes = 0;
+            for (const auto& event : results) {
+                bytes += event.GetMessage().size();
+            }
+
+            pending.events.reserve(results.size(), bytes);
+            for (const auto& event : results) {
+                auto [it, inserted] = streamIds.try_emplace(event.GetLogStreamName(), static_cast<uint32_t>(streamIds.size()));
+                if (inserted) {
+                    pending.newStreams.push_back(it->first);
+                }
+
+                pending.events.push(event.GetTimestamp(), event.GetMessage(), it->second);
+            }
+
+            if (shared->updates.tryPush(pending)) {
+                pending = Update{};
+                return;
+            }
+
+            shared->droppedUpdates.fetch_add(1, std::memory_order_relaxed);
+            shared->droppedEvents.fetch_add(pending.events.size(), std::memory_order_relaxed);
+            pending.events = sm::LogChunk{};
+        });
+
+        handler.SetOnErrorCallback([&](const Aws::Client::AWSError<Aws::CloudWatchLogs::CloudWatchLogsErrors>& error) {
+            if (!stop.stop_requested()) {
+                shared->errors.enqueue(error);
+            }
+        });
+
+        request.SetEventStreamHandler(handler);
+        sm::bindStopToken(request, stop);
+
+        //
+        // Sessions are closed by the service after a few hours, keep
+        // reconnecting until stopped. Every reconnect waits out a backoff
+        // that grows until a session starts again, so a session that
+        // closes right away doesn't hammer the service. Only errors that
+        // won't go away, or kMaxRetryAttempts in a row, end the tail.
+        //
+        std::mutex backoffMutex;
+        std::condition_variable_any backoffWake;
+        int failedAttempts = 0;
+
+        while (!stop.stop_requested()) {
+            auto outcome = client.StartLiveTail(request);
+            shared->isConnected.store(false);
+
+            if (stop.stop_requested()) {
+                break;
+            }
+
+            if (isStarted.exchange(false)) {
+                failedAttempts = 0;
+            }
+
+            if (!outcome.IsSuccess() && (!isRetryable(outcome.GetError()) || failedAttempts >= kMaxRetryAttempts)) {
+                shared->errors.enqueue(outcome.GetError());
+                break;
+            }
+
+            std::unique_lock lock(backoffMutex);
+            backoffWake.wait_for(lock, stop, sm::AdaptiveLimit::getBackoff(failedAttempts), [] { return false; });
+            failedAttempts += 1;
+        }
+
+        shared->isRunning.store(false);
+        shared->isFinished.store(true);
+    });
+
+    mStop = thread.get_stop_source();
+
+    SessionRegistry& registry = getRegistry();
+    std::lock_guard lock(registry.mutex);
+    if (registry.isShutdown) {
+        thread.request_stop();
+        thread.join();
+        return;
+    }
+
+    // Threads of sessions that have ended are joined here, that doesn't block.
+    std::erase_if(registry.threads, [](const SessionThread& session) {
+        return session.isFinished->load();
+    });
+
+    registry.threads.push_back(SessionThread{std::move(thread), std::shared_ptr<const std::atomic<bool>>(mShared, &mShared->isFinished)});
+}
+
+void LiveTail::cancel() {
+    if (!mShared) {
+        return;
+    }
+
+    //
+    // Stopping aborts the transfer at the next progress callback, don't
+    // hold the UI thread until then. The thread owns everything it uses
+    // and the registry joins it later.
+    //
+    mStop.request_stop();
+    mShared->isRunning.store(false);
+}
+
+void LiveTail::poll(sm::LogChunk& out, size_t maxEvents) {
+    if (!mShared) {
+        return;
+    }
+
+    CwlError error;
+    while (mShared->errors.try_dequeue(error)) {
+        mError = std::move(error);
+    }
+
+    Update update;
+    while (out.size() < maxEvents && mShared->updates.tryPop(update)) {
+        for (std::string& name : update.newStreams) {
+            mStreams.push_back(std::move(name));
+        }
+
+        out.append(update.events);
+    }
+}
+
+void LiveTail::shutdown() {
+    std::vector<SessionThread> threads;
+    {
+        SessionRegistry& registry = getRegistry();
+        std::lock_guard lock(registry.mutex);
+        registry.isShutdown = true;
+        threads = std::move(registry.threads);
+    }
+
+    for (SessionThread& session : threads) {
+        session.thread.request_stop();
+    }
+
+    // Destroying a jthread joins it.
+    threads.clear();
+}
+
+ImAws::LiveTailStats LiveTail::getStats() const {
+    if (!mShared) {
+        return LiveTailStats{};
+    }
+
+    return LiveTailStats {
+        .isConnected = mShared->isConnected.load(),
+        .isSampled = mShared->isSampled.load(),
+        .receivedEvents = mShared->receivedEvents.load(),
+        .sampledUpdates = mShared->sampledUpdates.load(),
+        .droppedEvents = mShared->droppedEvents.load(),
+        .droppedUpdates = mShared->droppedUpdates.load(),
+        .queuedUpdates = mShared->updates.size(),
+    };
+}
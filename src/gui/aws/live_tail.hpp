@@ -0,0 +1,110 @@
+#pragma once
+
+#include "gui/aws/window.hpp"
+#include "util/log_store.hpp"
+#include "util/ring_buffer.hpp"
+
+#include <aws/logs/CloudWatchLogsClient.h>
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include <concurrentqueue.h>
+
+namespace ImAws {
+    struct LiveTailStats {
+        bool isConnected;
+        bool isSampled; // the last update was sampled by CloudWatch
+        uint64_t receivedEvents;
+        uint64_t sampledUpdates;
+        uint64_t droppedEvents;
+        uint64_t droppedUpdates;
+        size_t queuedUpdates;
+    };
+
+    //
+    // A StartLiveTail session streamed over the event-stream protocol. The
+    // session runs on its own thread rather than the Executor as it can
+    // stay open for hours. Each session update is decoded on that thread
+    // into a LogChunk and pushed into a RingBuffer, the UI thread drains it
+    // in poll().
+    //
+    // When the UI falls behind the ring fills and whole updates are dropped,
+    // counted in droppedUpdates and droppedEvents. A session that ends on
+    // its own, such as at the service's session time limit, or fails with
+    // a retryable error is restarted after a backoff.
+    //
+    // Session threads are owned by a process wide registry rather than by
+    // their LiveTail. Cancelling only asks a thread to stop, so closing a
+    // window never waits on the network, and shutdown() joins every thread
+    // before the SDK is shut down.
+    //
+    class LiveTail {
+        using CwlError = Aws::CloudWatchLogs::CloudWatchLogsError;
+
+        //
+        // Stream names are numbered on the session thread in order of first
+        // appearance, each update carries the names it introduced. Names of
+        // a dropped update are carried into the next one so ids stay dense.
+        //
+        struct Update {
+            sm::LogChunk events;
+            std::vector<std::string> newStreams;
+        };
+
+        struct State {
+            sm::RingBuffer<Update> updates;
+            moodycamel::ConcurrentQueue<CwlError> errors;
+
+            std::atomic<bool> isRunning{true};
+            std::atomic<bool> isFinished{false}; // the session thread has returned
+            std::atomic<bool> isConnected{false};
+            std::atomic<bool> isSampled{false};
+            std::atomic<uint64_t> receivedEvents{0};
+            std::atomic<uint64_t> sampledUpdates{0};
+            std::atomic<uint64_t> droppedEvents{0};
+            std::atomic<uint64_t> droppedUpdates{0};
+
+            State(size_t capacity)
+                : updates(capacity)
+            { }
+        };
+
+        // Updates arrive about once a second with at most 500 events each.
+        static constexpr size_t kRingCapacity = 256;
+
+        std::shared_ptr<State> mShared;
+        std::stop_source mStop;
+
+        std::vector<std::string> mStreams;
+        std::optional<CwlError> mError;
+
+    public:
+        ~LiveTail();
+
+        /// @param logGroupArn Log group ARN, a trailing :* is removed.
+        void start(ClientContext context, std::string logGroupArn, std::string filterPattern);
+
+        void cancel();
+
+        /// @brief Move received updates into @p out until at least @p maxEvents
+        ///        events were moved or none are left.
+        void poll(sm::LogChunk& out, size_t maxEvents);
+
+        bool isActive() const { return mShared && mShared->isRunning.load(); }
+
+        bool hasError() const { return mError.has_value(); }
+        const CwlError& error() const { return mError.value(); }
+        void clear() { mError.reset(); }
+
+        /// @brief Names of the streams seen so far, event sources index into these.
+        const std::vector<std::string>& getStreams() const { return mStreams; }
+
+        LiveTailStats getStats() const;
+
+        /// @brief Stop and join every session thread, new sessions fail to start after this.
+        static void shutdown();
+    };
+}
@@ -0,0 +1,259 @@
+#include "log_fetch.hpp"
+
+#include "gui/aws/cancel.hpp"
+#include "gui/aws/pages/logs.hpp"
+#include "util/executor.hpp"
+
+#include <aws/logs/model/FilteredLogEvent.h>
+
+#include <algorithm>
+#include <numeric>
+#include <span>
+
+using ImAws::ShardedLogFetch;
+using FilteredLogEvent = Aws::CloudWatchLogs::Model::FilteredLogEvent;
+
+namespace {
+    //
+    // The merger needs each page in timestamp order, FilterLogEvents
+    // interleaves streams so that is not guaranteed.
+    //
+    sm::LogChunk projectSortedEvents(const Aws::Vector<FilteredLogEvent>& events, std::span<const uint32_t> sources) {
+        std::vector<uint32_t> order(events.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t lhs, uint32_t rhs) {
+            return events[lhs].GetTimestamp() < events[rhs].GetTimestamp();
+        });
+
+        size_t bytes = 0;
+        for (const auto& event : events) {
+            bytes += event.GetMessage().size();
+        }
+
+        sm::LogChunk chunk;
+        chunk.reserve(events.size(), bytes);
+        for (uint32_t i : order) {
+            chunk.push(events[i].GetTimestamp(), events[i].GetMessage(), sources[i]);
+        }
+
+        return chunk;
+    }
+}
+
+ShardedLogFetch::ShardedLogFetch() = default;
+
+ShardedLogFetch::~ShardedLogFetch() {
+    cancel();
+}
+
+void ShardedLogFetch::submitPage(size_t index) {
+    Shard& shard = mShards[index];
+    shard.status = ShardStatus::eRunning;
+
+    Request request = mRequest;
+    request.SetStartTime(shard.start);
+    request.SetEndTime(shard.end);
+    sm::FilterLogEventsPages::setPageSize(request, sm::FilterLogEventsPages::kMaxPageSize);
+    if (!shard.nextToken.empty()) {
+        request.SetNextToken(shard.nextToken);
+    }
+
+    sm::Executor::get().submit(mStop, [shared = mShared, client = mClient, generation = mGeneration, index, request = std::move(request)](std::stop_token stop) mutable {
+        sm::bindStopToken(request, stop);
+
+        auto outcome = sm::FilterLogEventsPages::call(client->get(), request);
+        if (stop.stop_requested()) {
+            return;
+        }
+
+        PageResult result{generation, index};
+        if (outcome.IsSuccess()) {
+            const auto& events = outcome.GetResult().GetEvents();
+
+            std::vector<uint32_t> sources;
+            sources.reserve(events.size());
+            {
+                std::lock_guard lock(shared->streamMutex);
+                if (shared->generation.load() != generation) {
+                    return;
+                }
+
+                for (const auto& event : events) {
+                    auto [it, inserted] = shared->streamIds.try_emplace(event.GetLogStreamName(), static_cast<uint32_t>(shared->streamIds.size()));
+                    if (inserted) {
+                        result.newStreams.emplace_back(it->second, it->first);
+                    }
+                    sources.push_back(it->second);
+                }
+            }
+
+            result.events = projectSortedEvents(events, sources);
+            result.nextToken = outcome.GetResult().GetNextToken();
+        } else {
+            result.error = outcome.GetError();
+        }
+
+        shared->results.enqueue(std::move(result));
+    });
+}
+
+void ShardedLogFetch::onRetry(Shard& shard, bool isThrottled, Clock::time_point now) {
+    if (isThrottled) {
+        mConcurrency.onThrottle();
+    }
+
+    shard.retryAt = now + sm::AdaptiveLimit::getBackoff(shard.failedAttempts);
+    shard.failedAttempts += 1;
+    shard.status = ShardStatus::eWaiting;
+}
+
+void ShardedLogFetch::onPageResult(PageResult result, Clock::time_point now) {
+    Shard& shard = mShards[result.shard];
+
+    if (result.error.has_value()) {
+        //
+        // Giving up on a shard leaves a gap in the merged events, so only
+        // do so for errors that won't go away or once retries run out.
+        //
+        if (isRetryable(*result.error) && shard.failedAttempts < kMaxRetryAttempts) {
+            onRetry(shard, isThrottle(*result.error), now);
+            return;
+        }
+
+        mError = std::move(result.error);
+        shard.status = ShardStatus::eDone;
+        mMerger.finish(result.shard);
+        return;
+    }
+
+    for (auto& [source, name] : result.newStreams) {
+        if (source >= mStreams.size()) {
+            mStreams.resize(source + 1);
+        }
+        mStreams[source] = std::move(name);
+    }
+
+    shard.failedAttempts = 0;
+    mMerger.push(result.shard, std::move(result.events));
+
+    mConcurrency.onSuccess();
+
+    if (result.nextToken.empty()) {
+        shard.status = ShardStatus::eDone;
+        mMerger.finish(result.shard);
+    } else {
+        shard.nextToken = std::move(result.nextToken);
+        shard.status = ShardStatus::eWaiting;
+        shard.retryAt = now;
+    }
+}
+
+void ShardedLogFetch::schedule(Clock::time_point now) {
+    size_t running = std::count_if(mShards.begin(), mShards.end(), [](const Shard& shard) {
+        return shard.status == ShardStatus::eRunning;
+    });
+
+    //
+    // Earlier shards go first, the merger cannot release anything past the
+    // oldest shard that is still open.
+    //
+    for (size_t i = 0; i < mShards.size() && running < mConcurrency.getLimit(); ++i) {
+        const Shard& shard = mShards[i];
+        bool isReady = shard.status == ShardStatus::ePending
+            || (shard.status == ShardStatus::eWaiting && shard.retryAt <= now && mMerger.getBufferedCount(i) < kMaxBufferedPerShard);
+
+        if (isReady) {
+            submitPage(i);
+            running += 1;
+        }
+    }
+}
+
+void ShardedLogFetch::start(ClientContext context, Request request, int64_t start, int64_t end, size_t shardCount) {
+    cancel();
+
+    mClient = std::make_shared<LogsClient>(std::move(context));
+    mRequest = std::move(request);
+    mError.reset();
+
+    //
+    // Both ends of a FilterLogEvents range are inclusive, so each shard
+    // stops one millisecond short of the next one.
+    //
+    shardCount = std::max<size_t>(1, std::min<size_t>(shardCount, static_cast<size_t>(end - start + 1)));
+    mConcurrency = sm::AdaptiveLimit{kInitialConcurrency, std::min(kMaxConcurrency, shardCount)};
+
+    int64_t span = end - start + 1;
+    for (size_t i = 0; i < shardCount; ++i) {
+        int64_t shardStart = start + span * static_cast<int64_t>(i) / static_cast<int64_t>(shardCount);
+        int64_t shardEnd = start + span * static_cast<int64_t>(i + 1) / static_cast<int64_t>(shardCount) - 1;
+
+        mShards.push_back(Shard{shardStart, shardEnd});
+        mMerger.addRun(shardStart);
+    }
+
+    schedule(Clock::now());
+}
+
+void ShardedLogFetch::cancel() {
+    mStop.request_stop();
+    mStop = std::stop_source{};
+
+    {
+        std::lock_guard lock(mShared->streamMutex);
+        mGeneration = mShared->generation.fetch_add(1) + 1;
+        mShared->streamIds.clear();
+    }
+
+    mShards.clear();
+    mStreams.clear();
+    mMerger.clear();
+    mClient.reset();
+}
+
+void ShardedLogFetch::poll(sm::LogChunk& out, size_t maxEvents) {
+    auto now = Clock::now();
+
+    PageResult result;
+    while (mShared->results.try_dequeue(result)) {
+        if (result.generation == mGeneration) {
+            onPageResult(std::move(result), now);
+        }
+    }
+
+    schedule(now);
+
+    mMerger.drain(out, maxEvents);
+}
+
+bool ShardedLogFetch::isWorking() const {
+    return std::any_of(mShards.begin(), mShards.end(), [](const Shard& shard) {
+        return shard.status != ShardStatus::eDone;
+    }) || mMerger.getBufferedCount() > 0;
+}
+
+ImAws::ShardedLogFetchStats ShardedLogFetch::getStats() const {
+    ShardedLogFetchStats stats {
+        .shardCount = mShards.size(),
+        .runningShards = 0,
+        .finishedShards = 0,
+        .concurrency = mConcurrency.getLimit(),
+        .throttleCount = mConcurrency.getThrottleCount(),
+        .bufferedEvents = mMerger.getBufferedCount(),
+    };
+
+    for (const Shard& shard : mShards) {
+        if (shard.status == ShardStatus::eRunning) {
+            stats.runningShards += 1;
+        } else if (shard.status == ShardStatus::eDone) {
+            stats.finishedShards += 1;
+        }
+    }
+
+    return stats;
+}
+
+size_t ShardedLogFetch::getShardCount(int64_t start, int64_t end, std::chrono::milliseconds shardDuration, size_t maxShards) {
+    int64_t shards = (end - start) / std::max<int64_t>(shardDuration.count(), 1) + 1;
+    return static_cast<size_t>(std::clamp<int64_t>(shards, 1, static_cast<int64_t>(maxShards)));
+}
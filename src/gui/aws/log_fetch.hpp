@@ -0,0 +1,152 @@
+#pragma once
+
+#include "gui/aws/shared_client.hpp"
+#include "gui/aws/window.hpp"
+#include "util/adaptive_limit.hpp"
+#include "util/log_merge.hpp"
+#include "util/log_store.hpp"
+
+#include <aws/logs/CloudWatchLogsClient.h>
+#include <aws/logs/model/FilterLogEventsRequest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <concurrentqueue.h>
+
+namespace ImAws {
+    struct ShardedLogFetchStats {
+        size_t shardCount;
+        size_t runningShards;
+        size_t finishedShards;
+        size_t concurrency;
+        size_t throttleCount;
+        size_t bufferedEvents;
+    };
+
+    //
+    // Fetches FilterLogEvents over a time range split into shards. Shards
+    // are paged concurrently on the Executor, one task per page, and their
+    // events are released in timestamp order through a LogMerger.
+    //
+    // The number of shards in flight is an AdaptiveLimit so it backs off
+    // under throttling. Throttled pages, and pages that failed with any other
+    // retryable error, are retried after a delay up to kMaxRetryAttempts
+    // times in a row.
+    //
+    // Scheduling happens in poll() on the UI thread, workers only issue
+    // requests and post the results back.
+    //
+    // Each event's source is the index of its log stream. Workers number
+    // streams as they first see them and send the new names back with the
+    // page, so a name is known before any of its events are released.
+    //
+    class ShardedLogFetch {
+        using Client = Aws::CloudWatchLogs::CloudWatchLogsClient;
+        using Request = Aws::CloudWatchLogs::Model::FilterLogEventsRequest;
+        using CwlError = Aws::CloudWatchLogs::CloudWatchLogsError;
+        using Clock = std::chrono::steady_clock;
+
+        enum class ShardStatus {
+            ePending,
+            eRunning,
+            eWaiting, // between pages, or backing off after a retryable error
+            eDone,
+        };
+
+        struct Shard {
+            int64_t start; // inclusive unix epoch milliseconds
+            int64_t end; // inclusive unix epoch milliseconds
+            ShardStatus status = ShardStatus::ePending;
+            Aws::String nextToken;
+            int failedAttempts = 0; // in a row
+            Clock::time_point retryAt;
+        };
+
+        struct PageResult {
+            uint32_t generation;
+            size_t shard;
+            std::optional<CwlError> error;
+            sm::LogChunk events;
+            std::vector<std::pair<uint32_t, std::string>> newStreams;
+            Aws::String nextToken;
+        };
+
+        using LogsClient = SharedClient<Client, Aws::CloudWatchLogs::CloudWatchLogsClientConfiguration>;
+
+        struct State {
+            std::atomic<uint32_t> generation{0};
+            moodycamel::ConcurrentQueue<PageResult> results;
+
+            std::mutex streamMutex;
+            std::unordered_map<std::string, uint32_t> streamIds; // of the current generation
+        };
+
+        static constexpr size_t kInitialConcurrency = 4;
+        static constexpr size_t kMaxConcurrency = 16;
+
+        // A shard stops fetching ahead once this many of its events are
+        // waiting in the merger for earlier shards to catch up.
+        static constexpr size_t kMaxBufferedPerShard = 50'000;
+
+        std::shared_ptr<State> mShared = std::make_shared<State>();
+        std::shared_ptr<LogsClient> mClient;
+        std::stop_source mStop;
+        uint32_t mGeneration = 0;
+
+        Request mRequest;
+        std::vector<Shard> mShards;
+        std::vector<std::string> mStreams; // by source
+        sm::LogMerger mMerger;
+
+        sm::AdaptiveLimit mConcurrency{kInitialConcurrency, kMaxConcurrency};
+
+        std::optional<CwlError> mError;
+
+        void submitPage(size_t index);
+        void onPageResult(PageResult result, Clock::time_point now);
+        void onRetry(Shard& shard, bool isThrottled, Clock::time_point now);
+        void schedule(Clock::time_point now);
+
+    public:
+        ShardedLogFetch();
+        ~ShardedLogFetch();
+
+        /// @brief Start fetching events between @p start and @p end, both
+        ///        unix epoch milliseconds, replacing any fetch in progress.
+        /// @param request Log group, filter pattern and other parameters,
+        ///        the time range and pagination fields are overwritten.
+        void start(ClientContext context, Request request, int64_t start, int64_t end, size_t shardCount);
+
+        /// @brief Stop without waiting, results still in flight are dropped.
+        void cancel();
+
+        /// @brief Process finished pages, start more of them, then move up
+        ///        to @p maxEvents ordered events into @p out.
+        void poll(sm::LogChunk& out, size_t maxEvents);
+
+        bool isWorking() const;
+
+        bool hasError() const { return mError.has_value(); }
+        const CwlError& error() const { return mError.value(); }
+        void clear() { mError.reset(); }
+
+        ShardedLogFetchStats getStats() const;
+
+        /// @brief Name of the log stream events with source @p source came from.
+        std::string_view getStreamName(uint32_t source) const {
+            return source < mStreams.size() ? std::string_view{mStreams[source]} : std::string_view{};
+        }
+
+        /// @brief A shard count giving each shard roughly @p shardDuration of the range.
+        static size_t getShardCount(int64_t start, int64_t end, std::chrono::milliseconds shardDuration, size_t maxShards);
+    };
+}
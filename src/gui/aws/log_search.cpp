@@ -0,0 +1,54 @@
+#include "log_search.hpp"
+
+#include "util/executor.hpp"
+
+using ImAws::LocalLogSearch;
+
+LocalLogSearch::~LocalLogSearch() {
+    cancel();
+}
+
+void LocalLogSearch::start(sm::LogSearchQuery query) {
+    cancel();
+
+    mIsWorking = true;
+    mError.clear();
+
+    sm::Executor::get().submit(mStop, [shared = mShared, generation = mGeneration, query = std::move(query)](std::stop_token stop) {
+        if (stop.stop_requested()) {
+            return;
+        }
+
+        Result result{generation};
+
+        auto start = std::chrono::steady_clock::now();
+        sm::LogDatabase::get().search(query, result.events, result.error);
+        result.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+        shared->results.enqueue(std::move(result));
+    });
+}
+
+void LocalLogSearch::cancel() {
+    mStop.request_stop();
+    mStop = std::stop_source{};
+    mGeneration += 1;
+    mIsWorking = false;
+}
+
+bool LocalLogSearch::poll(sm::LogChunk& out) {
+    Result result;
+    while (mShared->results.try_dequeue(result)) {
+        if (result.generation != mGeneration) {
+            continue;
+        }
+
+        mIsWorking = false;
+        mElapsed = result.elapsed;
+        mError = std::move(result.error);
+        out = std::move(result.events);
+        return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "util/log_db.hpp"
+#include "util/log_store.hpp"
+
+#include <chrono>
+#include <memory>
+#include <stop_token>
+#include <string>
+#include <concurrentqueue.h>
+
+namespace ImAws {
+    //
+    // Runs a search of the local LogDatabase on the Executor, so the UI
+    // thread never waits on SQLite. Only the newest search is kept, results
+    // of one that was replaced or cancelled are dropped in poll().
+    //
+    class LocalLogSearch {
+        struct Result {
+            uint32_t generation;
+            sm::LogChunk events;
+            std::chrono::microseconds elapsed;
+            std::string error;
+        };
+
+        struct State {
+            moodycamel::ConcurrentQueue<Result> results;
+        };
+
+        std::shared_ptr<State> mShared = std::make_shared<State>();
+        std::stop_source mStop;
+        uint32_t mGeneration = 0;
+        bool mIsWorking = false;
+
+        std::chrono::microseconds mElapsed{0};
+        std::string mError;
+
+    public:
+        ~LocalLogSearch();
+
+        void start(sm::LogSearchQuery query);
+        void cancel();
+
+        /// @brief Move the events of a finished search into @p out.
+        /// @return True if a search finished.
+        bool poll(sm::LogChunk& out);
+
+        bool isWorking() const { return mIsWorking; }
+
+        /// @brief Time the last finished search spent in the database.
+        std::chrono::microseconds getElapsed() const { return mElapsed; }
+
+        bool hasError() const { return !mError.empty(); }
+        const std::string& error() const { return mError; }
+        void clear() { mError.clear(); }
+    };
+}
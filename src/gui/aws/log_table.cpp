@@ -0,0 +1,108 @@
+#include "log_table.hpp"
+
+#include "util/time.hpp"
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <string>
+
+namespace {
+    // Rows are a single line high, only the first line of a message is shown inline.
+    std::string_view firstLine(std::string_view message) {
+        return message.substr(0, message.find_first_of("\r\n"));
+    }
+
+    // Draws @p count rows, @p getId maps a row to the id of its event.
+    template<typename F>
+    void drawRows(const char *id, const sm::LogEventStore& events, size_t count, uint64_t removed, bool followTail, const ImAws::LogSourceName& sourceName, sm::LogFieldCache *fields, F&& getId) {
+        bool showSource = static_cast<bool>(sourceName);
+        int fieldCount = fields != nullptr ? static_cast<int>(fields->getFieldCount()) : 0;
+        int fieldColumn = showSource ? 2 : 1;
+        int messageColumn = fieldColumn + fieldCount;
+
+        ImGuiTableFlags flags = ImGuiTableFlags_ScrollY | ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersOuter | ImGuiTableFlags_BordersV | ImGuiTableFlags_Resizable;
+        if (!ImGui::BeginTable(id, messageColumn + 1, flags)) {
+            return;
+        }
+
+        ImGui::TableSetupColumn("Time", ImGuiTableColumnFlags_WidthFixed, ImGui::GetFontSize() * 12.f);
+        if (showSource) {
+            ImGui::TableSetupColumn("Stream", ImGuiTableColumnFlags_WidthFixed, ImGui::GetFontSize() * 12.f);
+        }
+        for (int i = 0; i < fieldCount; ++i) {
+            ImGui::TableSetupColumn(fields->getName(i).c_str(), ImGuiTableColumnFlags_WidthFixed, ImGui::GetFontSize() * 8.f);
+        }
+        ImGui::TableSetupColumn("Message", ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableHeadersRow();
+
+        float rowHeight = ImGui::GetTextLineHeight() + ImGui::GetStyle().CellPadding.y * 2.f;
+        bool isAtBottom = ImGui::GetScrollY() >= ImGui::GetScrollMaxY();
+
+        //
+        // Removing rows from the front shifts every row up, move the scroll
+        // position with them so the rows being read stay in place.
+        //
+        if (removed > 0 && !isAtBottom) {
+            ImGui::SetScrollY(std::max(0.f, ImGui::GetScrollY() - static_cast<float>(removed) * rowHeight));
+        }
+
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(count), rowHeight);
+        while (clipper.Step()) {
+            for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+                uint64_t eventId = getId(static_cast<size_t>(i));
+                sm::LogEventView event = events.at(static_cast<size_t>(eventId - events.getEvictedCount()));
+                ImGui::TableNextRow();
+
+                ImGui::TableSetColumnIndex(0);
+                std::string time = sm::formatEpochMs(event.timestamp);
+                ImGui::TextUnformatted(time.data(), time.data() + time.size());
+
+                if (showSource) {
+                    ImGui::TableSetColumnIndex(1);
+                    std::string_view source = sourceName(event.source);
+                    ImGui::TextUnformatted(source.data(), source.data() + source.size());
+                }
+
+                // Only the visible rows are scanned for fields, and only once.
+                for (int field = 0; field < fieldCount; ++field) {
+                    ImGui::TableSetColumnIndex(fieldColumn + field);
+                    std::string_view text = fields->getText(events, eventId, static_cast<size_t>(field));
+                    ImGui::TextUnformatted(text.data(), text.data() + text.size());
+                }
+
+                ImGui::TableSetColumnIndex(messageColumn);
+                std::string_view line = firstLine(event.message);
+                ImGui::TextUnformatted(line.data(), line.data() + line.size());
+
+                if (line.size() != event.message.size() && ImGui::BeginItemTooltip()) {
+                    ImGui::PushTextWrapPos(ImGui::GetFontSize() * 60.f);
+                    ImGui::TextUnformatted(event.message.data(), event.message.data() + event.message.size());
+                    ImGui::PopTextWrapPos();
+                    ImGui::EndTooltip();
+                }
+            }
+        }
+
+        if (followTail && isAtBottom) {
+            ImGui::SetScrollHereY(1.f);
+        }
+
+        ImGui::EndTable();
+    }
+}
+
+void ImAws::drawLogEventTable(const char *id, const sm::LogEventStore& events, uint64_t evicted, bool followTail, const LogSourceName& sourceName, sm::LogFieldCache *fields) {
+    uint64_t first = events.getEvictedCount();
+    drawRows(id, events, events.size(), evicted, followTail, sourceName, fields, [&](size_t i) {
+        return first + i;
+    });
+}
+
+void ImAws::drawLogEventTable(const char *id, const sm::LogEventStore& events, std::span<const uint64_t> rows, uint64_t removed, bool followTail, const LogSourceName& sourceName, sm::LogFieldCache *fields) {
+    drawRows(id, events, rows.size(), removed, followTail, sourceName, fields, [&](size_t i) {
+        return rows[i];
+    });
+}
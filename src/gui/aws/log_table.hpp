@@ -0,0 +1,29 @@
+#pragma once
+
+#include "util/log_fields.hpp"
+#include "util/log_store.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string_view>
+
+namespace ImAws {
+    /// @brief Returns the display name of an event source, such as a log stream.
+    using LogSourceName = std::function<std::string_view(uint32_t source)>;
+
+    /// @brief Draw @p events as a clipped table with one row per event.
+    ///
+    /// @param evicted Events evicted from the store since the last frame,
+    ///        used to keep the rows being read in place.
+    /// @param followTail Keep the view at the newest event while it is scrolled to the bottom.
+    /// @param sourceName Adds a source column when set.
+    /// @param fields Adds a column per field when set.
+    void drawLogEventTable(const char *id, const sm::LogEventStore& events, uint64_t evicted, bool followTail, const LogSourceName& sourceName = {}, sm::LogFieldCache *fields = nullptr);
+
+    /// @brief Draw only the events of @p events whose ids are in @p rows,
+    ///        such as the matches of a LogGrep.
+    ///
+    /// @param removed Rows dropped from the front of @p rows since the last frame.
+    void drawLogEventTable(const char *id, const sm::LogEventStore& events, std::span<const uint64_t> rows, uint64_t removed, bool followTail, const LogSourceName& sourceName = {}, sm::LogFieldCache *fields = nullptr);
+}
@@ -0,0 +1,245 @@
+#include "log_tail.hpp"
+
+#include "gui/aws/cancel.hpp"
+#include "gui/aws/paginate.hpp"
+#include "gui/aws/pages/logs.hpp"
+#include "util/executor.hpp"
+
+#include <aws/logs/model/GetLogEventsRequest.h>
+#include <aws/logs/model/OrderBy.h>
+
+#include <algorithm>
+
+using ImAws::LogStreamTail;
+
+namespace {
+    constexpr int kMaxEventsPerPoll = 10000;
+}
+
+LogStreamTail::~LogStreamTail() {
+    cancel();
+}
+
+void LogStreamTail::listStreams(ClientContext context, size_t count) {
+    Aws::CloudWatchLogs::Model::DescribeLogStreamsRequest request;
+    request.SetLogGroupName(mLogGroupName);
+    request.SetOrderBy(Aws::CloudWatchLogs::Model::OrderBy::LastEventTime);
+    request.SetDescending(true);
+
+    mIsListing = true;
+
+    sm::Executor::get().submit(mStop, [shared = mShared, generation = mGeneration, context = std::move(context), request = std::move(request), count](std::stop_token stop) {
+        StreamListResult result{generation};
+
+        for (const auto& outcome : sm::paginate<sm::DescribeLogStreamsPages>(context, request, stop)) {
+            if (!outcome.IsSuccess()) {
+                result.error = outcome.GetError();
+                break;
+            }
+
+            for (const auto& stream : outcome.GetResult().GetLogStreams()) {
+                result.streams.push_back(LogStreamInfo {
+                    .name = stream.GetLogStreamName(),
+                    .lastEventTime = stream.GetLastEventTimestamp(),
+                    .eventCount = 0,
+                    .isCaughtUp = false,
+                });
+            }
+
+            if (result.streams.size() >= count) {
+                result.streams.resize(count);
+                break;
+            }
+        }
+
+        if (!stop.stop_requested()) {
+            shared->streamLists.enqueue(std::move(result));
+        }
+    });
+}
+
+void LogStreamTail::submitPoll(size_t index) {
+    Stream& stream = mStreams[index];
+    stream.status = StreamStatus::eRunning;
+
+    Aws::CloudWatchLogs::Model::GetLogEventsRequest request;
+    request.SetLogGroupName(mLogGroupName);
+    request.SetLogStreamName(stream.info.name);
+    request.SetStartFromHead(true);
+    request.SetLimit(kMaxEventsPerPoll);
+    if (stream.forwardToken.empty()) {
+        request.SetStartTime(mStartTime);
+    } else {
+        request.SetNextToken(stream.forwardToken);
+    }
+
+    sm::Executor::get().submit(mStop, [shared = mShared, client = mClient, generation = mGeneration, index, request = std::move(request)](std::stop_token stop) mutable {
+        sm::bindStopToken(request, stop);
+
+        auto outcome = client->get().GetLogEvents(request);
+        if (stop.stop_requested()) {
+            return;
+        }
+
+        EventsResult result{generation, index};
+        if (outcome.IsSuccess()) {
+            const auto& events = outcome.GetResult().GetEvents();
+
+            size_t bytes = 0;
+            for (const auto& event : events) {
+                bytes += event.GetMessage().size();
+            }
+
+            // Events from a single stream read from the head are already in order.
+            result.events.reserve(events.size(), bytes);
+            for (const auto& event : events) {
+                result.events.push(event.GetTimestamp(), event.GetMessage(), static_cast<uint32_t>(index));
+            }
+
+            result.forwardToken = outcome.GetResult().GetNextForwardToken();
+        } else {
+            result.error = outcome.GetError();
+        }
+
+        shared->events.enqueue(std::move(result));
+    });
+}
+
+void LogStreamTail::onStreamList(StreamListResult result) {
+    mIsListing = false;
+
+    if (result.error.has_value()) {
+        mError = std::move(result.error);
+    }
+
+    for (LogStreamInfo& info : result.streams) {
+        mStreams.push_back(Stream{.info = std::move(info)});
+        mMerger.addRun(mStartTime);
+    }
+
+    if (mStreams.empty()) {
+        mIsActive = false;
+    }
+}
+
+void LogStreamTail::onEvents(EventsResult result, Clock::time_point now) {
+    Stream& stream = mStreams[result.stream];
+
+    if (result.error.has_value()) {
+        // A transient error shouldn't end the tail of a stream, retry it like a throttle.
+        if (isRetryable(*result.error) && stream.failedAttempts < kMaxRetryAttempts) {
+            if (isThrottle(*result.error)) {
+                mConcurrency.onThrottle();
+            }
+
+            stream.status = StreamStatus::eWaiting;
+            stream.pollAt = now + sm::AdaptiveLimit::getBackoff(stream.failedAttempts);
+            stream.failedAttempts += 1;
+            return;
+        }
+
+        mError = std::move(result.error);
+        stream.status = StreamStatus::eStopped;
+        mMerger.finish(result.stream);
+        return;
+    }
+
+    mConcurrency.onSuccess();
+    stream.failedAttempts = 0;
+
+    //
+    // GetLogEvents hands back the token it was given once there is nothing
+    // newer, any other response may have more behind it.
+    //
+    bool isCaughtUp = result.events.empty() || result.forwardToken == stream.forwardToken;
+
+    if (!result.events.empty()) {
+        stream.info.eventCount += result.events.size();
+        stream.info.lastEventTime = std::max(stream.info.lastEventTime, result.events.getTimestamp(result.events.size() - 1));
+    }
+
+    stream.info.isCaughtUp = isCaughtUp;
+    stream.forwardToken = std::move(result.forwardToken);
+    stream.status = StreamStatus::eWaiting;
+    stream.pollAt = isCaughtUp ? now + kPollInterval : now;
+
+    mMerger.push(result.stream, std::move(result.events));
+    mMerger.setIdle(result.stream, isCaughtUp);
+}
+
+void LogStreamTail::schedule(Clock::time_point now) {
+    size_t running = std::count_if(mStreams.begin(), mStreams.end(), [](const Stream& stream) {
+        return stream.status == StreamStatus::eRunning;
+    });
+
+    //
+    // Start from where the last pass stopped so streams with a backlog
+    // can't keep the ones after them from being polled.
+    //
+    for (size_t n = 0; n < mStreams.size() && running < mConcurrency.getLimit(); ++n) {
+        size_t index = (mNextStream + n) % mStreams.size();
+        const Stream& stream = mStreams[index];
+        if (stream.status == StreamStatus::eWaiting && stream.pollAt <= now && mMerger.getBufferedCount(index) < kMaxBufferedPerStream) {
+            submitPoll(index);
+            running += 1;
+            mNextStream = index + 1;
+        }
+    }
+}
+
+void LogStreamTail::start(ClientContext context, std::string logGroupName, size_t streamCount, std::chrono::milliseconds lookback) {
+    cancel();
+
+    auto now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch());
+
+    mStreams.clear();
+    mIsActive = true;
+
+    mClient = std::make_shared<LogsClient>(context);
+    mLogGroupName = std::move(logGroupName);
+    mStartTime = (now - lookback).count();
+    mConcurrency = sm::AdaptiveLimit{kInitialConcurrency, std::min(kMaxConcurrency, std::max<size_t>(streamCount, 1))};
+    mError.reset();
+
+    listStreams(std::move(context), streamCount);
+}
+
+void LogStreamTail::cancel() {
+    mStop.request_stop();
+    mStop = std::stop_source{};
+    mGeneration += 1;
+
+    //
+    // Streams are kept so events already handed out can still be matched
+    // to the stream they came from, they are only replaced by start().
+    //
+    mIsActive = false;
+    mIsListing = false;
+    mNextStream = 0;
+    mMerger.clear();
+    mClient.reset();
+}
+
+void LogStreamTail::poll(sm::LogChunk& out, size_t maxEvents) {
+    auto now = Clock::now();
+
+    StreamListResult list;
+    while (mShared->streamLists.try_dequeue(list)) {
+        if (list.generation == mGeneration) {
+            onStreamList(std::move(list));
+        }
+    }
+
+    EventsResult events;
+    while (mShared->events.try_dequeue(events)) {
+        if (events.generation == mGeneration) {
+            onEvents(std::move(events), now);
+        }
+    }
+
+    if (mIsActive) {
+        schedule(now);
+    }
+
+    mMerger.drain(out, maxEvents);
+}
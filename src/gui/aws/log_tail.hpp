@@ -0,0 +1,138 @@
+#pragma once
+
+#include "gui/aws/shared_client.hpp"
+#include "gui/aws/window.hpp"
+#include "util/adaptive_limit.hpp"
+#include "util/log_merge.hpp"
+#include "util/log_store.hpp"
+
+#include <aws/logs/CloudWatchLogsClient.h>
+
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <vector>
+#include <concurrentqueue.h>
+
+namespace ImAws {
+    struct LogStreamInfo {
+        std::string name;
+        int64_t lastEventTime; // unix epoch milliseconds
+        size_t eventCount;
+        bool isCaughtUp;
+    };
+
+    //
+    // Follows the most recently active streams of a log group. Streams are
+    // listed once with DescribeLogStreams ordered by LastEventTime, then each
+    // one is polled with GetLogEvents from its own forward token. Polls run
+    // concurrently on the Executor under an AdaptiveLimit and the streams
+    // are merged into one feed by a LogMerger.
+    //
+    // A stream that has caught up is marked idle in the merger, so it does
+    // not hold back the others between polls. Results are merged in the same
+    // poll() that receives them.
+    //
+    class LogStreamTail {
+        using Client = Aws::CloudWatchLogs::CloudWatchLogsClient;
+        using CwlError = Aws::CloudWatchLogs::CloudWatchLogsError;
+        using Clock = std::chrono::steady_clock;
+        using LogsClient = SharedClient<Client, Aws::CloudWatchLogs::CloudWatchLogsClientConfiguration>;
+
+        enum class StreamStatus {
+            eRunning,
+            eWaiting,
+            eStopped, // failed with an error that retrying will not fix
+        };
+
+        struct Stream {
+            LogStreamInfo info;
+            Aws::String forwardToken;
+            StreamStatus status = StreamStatus::eWaiting;
+            int failedAttempts = 0; // in a row
+            Clock::time_point pollAt;
+        };
+
+        struct StreamListResult {
+            uint32_t generation;
+            std::optional<CwlError> error;
+            std::vector<LogStreamInfo> streams;
+        };
+
+        struct EventsResult {
+            uint32_t generation;
+            size_t stream;
+            std::optional<CwlError> error;
+            sm::LogChunk events;
+            Aws::String forwardToken;
+        };
+
+        struct State {
+            moodycamel::ConcurrentQueue<StreamListResult> streamLists;
+            moodycamel::ConcurrentQueue<EventsResult> events;
+        };
+
+        static constexpr size_t kInitialConcurrency = 4;
+        static constexpr size_t kMaxConcurrency = 16;
+
+        // How often a stream that has caught up is polled again.
+        static constexpr std::chrono::seconds kPollInterval{2};
+
+        // A stream with a backlog stops being polled once this many of its
+        // events are waiting in the merger, such as behind a stream that is
+        // backing off after an error.
+        static constexpr size_t kMaxBufferedPerStream = 50'000;
+
+        std::shared_ptr<State> mShared = std::make_shared<State>();
+        std::shared_ptr<LogsClient> mClient;
+        std::stop_source mStop;
+        uint32_t mGeneration = 0;
+
+        std::string mLogGroupName;
+        int64_t mStartTime = 0;
+        bool mIsActive = false;
+        bool mIsListing = false;
+        size_t mNextStream = 0;
+
+        std::vector<Stream> mStreams;
+        sm::LogMerger mMerger;
+        sm::AdaptiveLimit mConcurrency{kInitialConcurrency, kMaxConcurrency};
+
+        std::optional<CwlError> mError;
+
+        void listStreams(ClientContext context, size_t count);
+        void submitPoll(size_t index);
+        void onStreamList(StreamListResult result);
+        void onEvents(EventsResult result, Clock::time_point now);
+        void schedule(Clock::time_point now);
+
+    public:
+        ~LogStreamTail();
+
+        /// @brief Start following the @p streamCount most recently written
+        ///        streams of @p logGroupName, beginning @p lookback ago.
+        void start(ClientContext context, std::string logGroupName, size_t streamCount, std::chrono::milliseconds lookback);
+
+        void cancel();
+
+        /// @brief Process finished polls, start more of them, then move up
+        ///        to @p maxEvents merged events into @p out.
+        void poll(sm::LogChunk& out, size_t maxEvents);
+
+        bool isActive() const { return mIsActive; }
+
+        bool hasError() const { return mError.has_value(); }
+        const CwlError& error() const { return mError.value(); }
+        void clear() { mError.reset(); }
+
+        /// @brief Streams of the last start(), event sources index into these.
+        size_t getStreamCount() const { return mStreams.size(); }
+        const LogStreamInfo& getStream(size_t index) const { return mStreams[index].info; }
+
+        size_t getConcurrency() const { return mConcurrency.getLimit(); }
+        size_t getThrottleCount() const { return mConcurrency.getThrottleCount(); }
+        size_t getBufferedCount() const { return mMerger.getBufferedCount(); }
+    };
+}
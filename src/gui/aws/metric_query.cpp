@@ -0,0 +1,74 @@
+#include "metric_query.hpp"
+
+#include <aws/monitoring/model/MetricDataQuery.h>
+#include <aws/monitoring/model/ScanBy.h>
+
+#include <algorithm>
+#include <charconv>
+#include <format>
+
+using ImAws::MetricQueryPlanner;
+
+void MetricQueryPlanner::add(sm::SeriesId series, MetricStat stat, int64_t start) {
+    auto it = std::find_if(mPending.begin(), mPending.end(), [&](const Pending& pending) {
+        return pending.series == series;
+    });
+
+    if (it != mPending.end()) {
+        it->start = std::min(it->start, start);
+        return;
+    }
+
+    mPending.push_back(Pending{series, std::move(stat), start});
+}
+
+std::optional<MetricQueryPlanner::Request> MetricQueryPlanner::next(Aws::Utils::DateTime end) {
+    if (mPending.empty()) {
+        return std::nullopt;
+    }
+
+    size_t count = std::min(mPending.size(), kMaxQueries);
+
+    Request request;
+    int64_t start = end.Millis();
+    for (size_t i = 0; i < count; ++i) {
+        Aws::CloudWatch::Model::MetricDataQuery query;
+        query.SetId(getQueryId(mPending[i].series));
+        query.SetMetricStat(std::move(mPending[i].stat));
+        request.AddMetricDataQueries(std::move(query));
+
+        start = std::min(start, mPending[i].start);
+    }
+
+    mPending.erase(mPending.begin(), mPending.begin() + static_cast<ptrdiff_t>(count));
+
+    //
+    // MaxDatapoints is left at its maximum, it bounds the points of all
+    // queries together so anything lower pages a large batch into many
+    // more calls. Series are appended to in time order, the default
+    // is newest first.
+    //
+    request.SetStartTime(Aws::Utils::DateTime{start});
+    request.SetEndTime(end);
+    request.SetScanBy(Aws::CloudWatch::Model::ScanBy::TimestampAscending);
+    return request;
+}
+
+std::string MetricQueryPlanner::getQueryId(sm::SeriesId series) {
+    // Ids must start with a lowercase letter.
+    return std::format("s{}", series);
+}
+
+std::optional<sm::SeriesId> MetricQueryPlanner::parseQueryId(std::string_view id) {
+    if (id.size() < 2 || id[0] != 's') {
+        return std::nullopt;
+    }
+
+    sm::SeriesId series = 0;
+    auto [ptr, ec] = std::from_chars(id.data() + 1, id.data() + id.size(), series);
+    if (ec != std::errc{} || ptr != id.data() + id.size()) {
+        return std::nullopt;
+    }
+
+    return series;
+}
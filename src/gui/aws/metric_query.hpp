@@ -0,0 +1,57 @@
+#pragma once
+
+#include "util/time_series.hpp"
+
+#include <aws/core/utils/DateTime.h>
+#include <aws/monitoring/model/GetMetricDataRequest.h>
+#include <aws/monitoring/model/MetricStat.h>
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ImAws {
+    //
+    // Collects the series a view wants fetched and packs them into as few
+    // GetMetricData requests as possible, up to kMaxQueries queries each.
+    // A request covers the union of the time ranges of its queries, points
+    // a series already has are dropped again when appended.
+    //
+    // Every query id names its series so results are routed back by id
+    // alone, see getQueryId and parseQueryId.
+    //
+    class MetricQueryPlanner {
+        using Request = Aws::CloudWatch::Model::GetMetricDataRequest;
+        using MetricStat = Aws::CloudWatch::Model::MetricStat;
+
+    public:
+        static constexpr size_t kMaxQueries = 500;
+
+    private:
+        struct Pending {
+            sm::SeriesId series;
+            MetricStat stat;
+            int64_t start; // unix epoch milliseconds
+        };
+
+        std::vector<Pending> mPending;
+
+    public:
+        /// @brief Queue @p series to be fetched from @p start onwards.
+        ///        A series already queued keeps the earlier of the two starts.
+        void add(sm::SeriesId series, MetricStat stat, int64_t start);
+
+        /// @brief Take up to kMaxQueries queued series as one request ending at @p end.
+        /// @return The request, or nothing if no series are queued.
+        std::optional<Request> next(Aws::Utils::DateTime end);
+
+        void clear() { mPending.clear(); }
+
+        bool empty() const { return mPending.empty(); }
+        size_t size() const { return mPending.size(); }
+
+        static std::string getQueryId(sm::SeriesId series);
+        static std::optional<sm::SeriesId> parseQueryId(std::string_view id);
+    };
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <aws/iam/IAMClient.h>
+#include <aws/iam/model/ListRolesRequest.h>
+
+namespace sm {
+    struct ListRolesPages {
+        using Client = Aws::IAM::IAMClient;
+        using Config = Aws::IAM::IAMClientConfiguration;
+        using Request = Aws::IAM::Model::ListRolesRequest;
+        using Result = Aws::IAM::Model::ListRolesResult;
+        using Outcome = Aws::IAM::Model::ListRolesOutcome;
+
+        static constexpr int kMaxPageSize = 1000;
+
+        static Outcome call(const Client& client, const Request& request) { return client.ListRoles(request); }
+        static void setPageSize(Request& request, int size) { request.SetMaxItems(size); }
+        static void setToken(Request& request, const Aws::String& token) { request.SetMarker(token); }
+        static Aws::String getToken(const Result& result) { return result.GetMarker(); }
+    };
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <aws/logs/CloudWatchLogsClient.h>
+#include <aws/logs/model/DescribeLogGroupsRequest.h>
+#include <aws/logs/model/DescribeLogStreamsRequest.h>
+#include <aws/logs/model/FilterLogEventsRequest.h>
+
+namespace sm {
+    struct DescribeLogGroupsPages {
+        using Client = Aws::CloudWatchLogs::CloudWatchLogsClient;
+        using Config = Aws::CloudWatchLogs::CloudWatchLogsClientConfiguration;
+        using Request = Aws::CloudWatchLogs::Model::DescribeLogGroupsRequest;
+        using Result = Aws::CloudWatchLogs::Model::DescribeLogGroupsResult;
+        using Outcome = Aws::CloudWatchLogs::Model::DescribeLogGroupsOutcome;
+
+        static constexpr int kMaxPageSize = 50;
+
+        static Outcome call(const Client& client, const Request& request) { return client.DescribeLogGroups(request); }
+        static void setPageSize(Request& request, int size) { request.SetLimit(size); }
+        static void setToken(Request& request, const Aws::String& token) { request.SetNextToken(token); }
+        static Aws::String getToken(const Result& result) { return result.GetNextToken(); }
+    };
+
+    struct FilterLogEventsPages {
+        using Client = Aws::CloudWatchLogs::CloudWatchLogsClient;
+        using Config = Aws::CloudWatchLogs::CloudWatchLogsClientConfiguration;
+        using Request = Aws::CloudWatchLogs::Model::FilterLogEventsRequest;
+        using Result = Aws::CloudWatchLogs::Model::FilterLogEventsResult;
+        using Outcome = Aws::CloudWatchLogs::Model::FilterLogEventsOutcome;
+
+        static constexpr int kMaxPageSize = 10000;
+
+        static Outcome call(const Client& client, const Request& request) { return client.FilterLogEvents(request); }
+        static void setPageSize(Request& request, int size) { request.SetLimit(size); }
+        static void setToken(Request& request, const Aws::String& token) { request.SetNextToken(token); }
+        static Aws::String getToken(const Result& result) { return result.GetNextToken(); }
+    };
+
+    struct DescribeLogStreamsPages {
+        using Client = Aws::CloudWatchLogs::CloudWatchLogsClient;
+        using Config = Aws::CloudWatchLogs::CloudWatchLogsClientConfiguration;
+        using Request = Aws::CloudWatchLogs::Model::DescribeLogStreamsRequest;
+        using Result = Aws::CloudWatchLogs::Model::DescribeLogStreamsResult;
+        using Outcome = Aws::CloudWatchLogs::Model::DescribeLogStreamsOutcome;
+
+        static constexpr int kMaxPageSize = 50;
+
+        static Outcome call(const Client& client, const Request& request) { return client.DescribeLogStreams(request); }
+        static void setPageSize(Request& request, int size) { request.SetLimit(size); }
+        static void setToken(Request& request, const Aws::String& token) { request.SetNextToken(token); }
+        static Aws::String getToken(const Result& result) { return result.GetNextToken(); }
+    };
+}
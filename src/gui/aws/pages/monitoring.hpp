@@ -0,0 +1,34 @@
+#pragma once
+
+#include <aws/monitoring/CloudWatchClient.h>
+#include <aws/monitoring/model/ListMetricsRequest.h>
+#include <aws/monitoring/model/GetMetricDataRequest.h>
+
+namespace sm {
+    //
+    // ListMetrics has no page size parameter, it always returns up to 500.
+    //
+    struct ListMetricsPages {
+        using Client = Aws::CloudWatch::CloudWatchClient;
+        using Config = Aws::CloudWatch::CloudWatchClientConfiguration;
+        using Request = Aws::CloudWatch::Model::ListMetricsRequest;
+        using Result = Aws::CloudWatch::Model::ListMetricsResult;
+        using Outcome = Aws::CloudWatch::Model::ListMetricsOutcome;
+
+        static Outcome call(const Client& client, const Request& request) { return client.ListMetrics(request); }
+        static void setToken(Request& request, const Aws::String& token) { request.SetNextToken(token); }
+        static Aws::String getToken(const Result& result) { return result.GetNextToken(); }
+    };
+
+    struct GetMetricDataPages {
+        using Client = Aws::CloudWatch::CloudWatchClient;
+        using Config = Aws::CloudWatch::CloudWatchClientConfiguration;
+        using Request = Aws::CloudWatch::Model::GetMetricDataRequest;
+        using Result = Aws::CloudWatch::Model::GetMetricDataResult;
+        using Outcome = Aws::CloudWatch::Model::GetMetricDataOutcome;
+
+        static Outcome call(const Client& client, const Request& request) { return client.GetMetricData(request); }
+        static void setToken(Request& request, const Aws::String& token) { request.SetNextToken(token); }
+        static Aws::String getToken(const Result& result) { return result.GetNextToken(); }
+    };
+}
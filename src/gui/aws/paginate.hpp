@@ -0,0 +1,71 @@
+#pragma once
+
+#include "gui/aws/cancel.hpp"
+#include "gui/aws/window.hpp"
+#include "util/generator.hpp"
+
+#include <concepts>
+#include <stop_token>
+
+namespace sm {
+    //
+    // Describes a single paginated AWS API so the NextToken/Marker loop
+    // only has to be written once. A traits type provides the client,
+    // its configuration, request and outcome types, how to issue the call
+    // and how to move the continuation token between result and request.
+    // APIs with a page size also provide kMaxPageSize and setPageSize.
+    //
+    template<typename T>
+    concept PageTraits = requires(const typename T::Client& client, typename T::Request& request, const typename T::Outcome& outcome) {
+        typename T::Config;
+        { T::call(client, request) } -> std::same_as<typename T::Outcome>;
+        T::setToken(request, Aws::String{});
+        { T::getToken(outcome.GetResult()) } -> std::convertible_to<Aws::String>;
+    };
+
+    template<typename T>
+    concept SizedPageTraits = PageTraits<T> && requires(typename T::Request& request) {
+        { T::kMaxPageSize } -> std::convertible_to<int>;
+        T::setPageSize(request, T::kMaxPageSize);
+    };
+
+    /// @brief Lazily fetch every page of a paginated API.
+    ///
+    /// Each resumption issues one request and yields its outcome, an
+    /// unsuccessful outcome is yielded once and ends the sequence. The page
+    /// size is set to the API maximum and the in-flight request is aborted
+    /// as soon as @p stop is signalled.
+    template<PageTraits T>
+    Generator<typename T::Outcome> paginate(ImAws::ClientContext context, typename T::Request request, std::stop_token stop) {
+        auto client = ImAws::createClient<typename T::Client, typename T::Config>(context);
+
+        if constexpr (SizedPageTraits<T>) {
+            T::setPageSize(request, T::kMaxPageSize);
+        }
+
+        bindStopToken(request, stop);
+
+        Aws::String token;
+        do {
+            if (!token.empty()) {
+                T::setToken(request, token);
+            }
+
+            auto outcome = T::call(client, request);
+            if (stop.stop_requested()) {
+                co_return;
+            }
+
+            bool success = outcome.IsSuccess();
+            if (success) {
+                token = T::getToken(outcome.GetResult());
+            }
+
+            co_yield std::move(outcome);
+
+            if (!success) {
+                co_return;
+            }
+        } while (!token.empty() && !stop.stop_requested());
+    }
+}
@@ -34,12 +34,22 @@ void ImAws::Session::drawSessionInfo() {
     }
 }
 
+void ImAws::Session::addWindow(std::unique_ptr<IWindow> window) {
+    mPendingWindows.push_back(std::move(window));
+}
+
 void ImAws::Session::draw() {
     drawSessionInfo();
 
     for (auto& window : mWindows) {
         window->drawWindow();
     }
+
+    for (auto& window : mPendingWindows) {
+        mWindows.push_back(std::move(window));
+    }
+
+    mPendingWindows.clear();
 }
 
 void ImAws::Session::drawMenu() {
@@ -3,6 +3,8 @@
 #include <vector>
 #include <memory>
 
+#include "util/time_series.hpp"
+
 #include "aws/core/auth/AWSCredentialsProvider.h"
 #include "aws/sts/model/GetCallerIdentityResult.h"
 
@@ -20,8 +22,16 @@ namespace ImAws {
 
     class Session {
         std::vector<std::unique_ptr<IWindow>> mWindows;
+
+        // Windows opened by other windows while drawing, moved into
+        // mWindows once the draw loop is done with it.
+        std::vector<std::unique_ptr<IWindow>> mPendingWindows;
+
         SessionInfo mInfo;
 
+        // Metric data fetched by any window of this session.
+        sm::TimeSeriesStore mTimeSeries;
+
         void drawSessionInfo();
 
     public:
@@ -35,6 +45,10 @@ namespace ImAws {
             return mInfo.region;
         }
 
+        sm::TimeSeriesStore& getTimeSeries() { return mTimeSeries; }
+
+        void addWindow(std::unique_ptr<IWindow> window);
+
         void draw();
 
         void drawMenu();
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "gui/aws/window.hpp"
+
+#include <aws/core/client/AWSError.h>
+#include <aws/core/client/CoreErrors.h>
+#include <aws/core/client/DefaultRetryStrategy.h>
+
+#include <memory>
+#include <mutex>
+#include <optional>
+
+namespace ImAws {
+    /// @brief Whether @p error is the service asking the caller to slow down.
+    ///        Service error enums share the values of CoreErrors.
+    template<typename E>
+    bool isThrottle(const Aws::Client::AWSError<E>& error) {
+        return static_cast<int>(error.GetErrorType()) == static_cast<int>(Aws::Client::CoreErrors::THROTTLING)
+            || error.GetResponseCode() == Aws::Http::HttpResponseCode::TOO_MANY_REQUESTS;
+    }
+
+    /// @brief Whether @p error may succeed if the request is sent again:
+    ///        throttles, server errors and dropped connections.
+    template<typename E>
+    bool isRetryable(const Aws::Client::AWSError<E>& error) {
+        return isThrottle(error) || error.ShouldRetry();
+    }
+
+    // Failed attempts in a row after which a request is given up on, even if its errors are retryable.
+    constexpr int kMaxRetryAttempts = 8;
+
+    //
+    // One client shared by every task of a fetch, created by whichever
+    // worker needs it first. The SDK's own retries are disabled so that
+    // throttles and transient errors reach the caller, which checks them
+    // with isRetryable. It can then back off across all its tasks rather
+    // than each request retrying on its own.
+    //
+    template<typename Client, typename Config>
+    class SharedClient {
+        struct Holder {
+            Client client;
+
+            Holder(const ClientContext& context)
+                : client(createClient<Client, Config>(context, [](Config& config) {
+                    config.retryStrategy = std::make_shared<Aws::Client::DefaultRetryStrategy>(0);
+                }))
+            { }
+        };
+
+        ClientContext mContext;
+        std::once_flag mOnce;
+        std::optional<Holder> mHolder;
+
+    public:
+        SharedClient(ClientContext context)
+            : mContext(std::move(context))
+        { }
+
+        const Client& get() {
+            std::call_once(mOnce, [this] { mHolder.emplace(mContext); });
+            return mHolder->client;
+        }
+    };
+}
@@ -0,0 +1,352 @@
+#pragma once
+
+#include "gui/imaws.hpp"
+#include "util/arn.hpp"
+#include "util/intern.hpp"
+#include "util/row_filter.hpp"
+#include "util/sort_index.hpp"
+#include "util/trigram.hpp"
+
+#include <imgui.h>
+#include <misc/cpp/imgui_stdlib.h>
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace ImAws {
+    template<size_t N>
+    struct ColumnLabel {
+        char text[N];
+
+        constexpr ColumnLabel(const char (&str)[N]) {
+            std::copy_n(str, N, text);
+        }
+    };
+
+    //
+    // Column descriptors. Each one is a type with only static members so the
+    // table can call them directly for every row, nothing is dispatched at
+    // runtime. A descriptor provides:
+    //
+    //   kLabel       header text
+    //   kSearchable  whether the filter box matches against getText
+    //   getText      interned display text, also used for CSV export
+    //   less         sort order
+    //   draw         renders the cell
+    //
+
+    template<ColumnLabel Label, auto Member, bool Searchable = true>
+    struct TextColumn {
+        static constexpr const char *kLabel = Label.text;
+        static constexpr bool kSearchable = Searchable;
+
+        template<typename Row>
+        static sm::InternedString getText(const Row& row) {
+            return row.*Member;
+        }
+
+        template<typename Row>
+        static bool less(const Row& lhs, const Row& rhs) {
+            return getText(lhs).view() < getText(rhs).view();
+        }
+
+        template<typename Row>
+        static void draw(const Row& row) {
+            sm::InternedString text = getText(row);
+            ImGui::TextUnformatted(text.data(), text.end());
+        }
+    };
+
+    template<ColumnLabel Label, auto Member, bool Searchable = false>
+    struct ArnColumn {
+        static constexpr const char *kLabel = Label.text;
+        static constexpr bool kSearchable = Searchable;
+
+        template<typename Row>
+        static sm::InternedString getText(const Row& row) {
+            return (row.*Member).getText();
+        }
+
+        template<typename Row>
+        static bool less(const Row& lhs, const Row& rhs) {
+            return getText(lhs).view() < getText(rhs).view();
+        }
+
+        template<typename Row>
+        static void draw(const Row& row) {
+            ImAws::ArnTooltip(row.*Member);
+        }
+    };
+
+    //
+    // Sorted by the raw epoch value in `Member`, displayed using the text
+    // formatted with sm::formatEpochMs into `TextMember` at projection time.
+    //
+    template<ColumnLabel Label, auto Member, auto TextMember>
+    struct TimestampColumn {
+        static constexpr const char *kLabel = Label.text;
+        static constexpr bool kSearchable = false;
+
+        template<typename Row>
+        static sm::InternedString getText(const Row& row) {
+            return row.*TextMember;
+        }
+
+        template<typename Row>
+        static bool less(const Row& lhs, const Row& rhs) {
+            return lhs.*Member < rhs.*Member;
+        }
+
+        template<typename Row>
+        static void draw(const Row& row) {
+            sm::InternedString text = getText(row);
+            ImGui::TextUnformatted(text.data(), text.end());
+        }
+    };
+
+    namespace detail {
+        // RFC 4180 quoting, only applied when the field needs it.
+        inline void appendCsvField(std::string& csv, std::string_view field) {
+            if (field.find_first_of(",\"\r\n") == std::string_view::npos) {
+                csv += field;
+                return;
+            }
+
+            csv += '"';
+            for (char c : field) {
+                if (c == '"') {
+                    csv += '"';
+                }
+                csv += c;
+            }
+            csv += '"';
+        }
+    }
+
+    template<typename Row>
+    concept SearchableRow = requires(Row row) {
+        { row.searchId } -> std::convertible_to<uint32_t>;
+    };
+
+    //
+    // Sortable, filterable, virtualized table over rows projected by an
+    // AsyncDescribe. Every column keeps a sort index that is extended as
+    // rows arrive, and rows are indexed for the filter box on the worker
+    // thread with indexRows before they are handed to the describe.
+    //
+    template<SearchableRow Row, typename... Columns>
+    class ResourceTable {
+        static constexpr size_t kColumnCount = sizeof...(Columns);
+        using ColumnTuple = std::tuple<Columns...>;
+
+        template<size_t I>
+        using ColumnAt = std::tuple_element_t<I, ColumnTuple>;
+
+        std::array<sm::SortIndex, kColumnCount> mSortIndices;
+        size_t mSortColumn = 0;
+        bool mSortDescending = false;
+
+        sm::RowFilter mRowFilter;
+        std::string mSearchText;
+        std::vector<uint32_t> mVisibleRows;
+
+        ImGuiTableFlags mTableFlags{ImGuiTableFlags_Sortable | ImGuiTableFlags_Resizable | ImGuiTableFlags_Reorderable | ImGuiTableFlags_Hideable | ImGuiTableFlags_BordersOuter | ImGuiTableFlags_BordersV | ImGuiTableFlags_ScrollY};
+
+        template<size_t... I>
+        void updateSortIndices(std::span<const Row> rows, std::index_sequence<I...>) {
+            (mSortIndices[I].update(rows.size(), [&](uint32_t lhs, uint32_t rhs) {
+                return ColumnAt<I>::less(rows[lhs], rows[rhs]);
+            }), ...);
+        }
+
+        template<size_t... I>
+        static void setupColumns(std::index_sequence<I...>) {
+            (ImGui::TableSetupColumn(
+                Columns::kLabel,
+                ImGuiTableColumnFlags_WidthStretch | (I == 0 ? ImGuiTableColumnFlags_DefaultSort : 0),
+                0.f,
+                static_cast<ImGuiID>(I)
+            ), ...);
+        }
+
+        //
+        // Returns true if the row was double clicked. The row is covered by
+        // one selectable spanning every column, the cells are drawn over it.
+        //
+        template<size_t... I>
+        static bool drawRow(const Row& row, uint32_t index, std::index_sequence<I...>) {
+            ImGui::TableSetColumnIndex(0);
+            ImGui::PushID(static_cast<int>(index));
+            ImVec2 cursor = ImGui::GetCursorScreenPos();
+            bool clicked = ImGui::Selectable("##Row", false, ImGuiSelectableFlags_SpanAllColumns | ImGuiSelectableFlags_AllowOverlap | ImGuiSelectableFlags_AllowDoubleClick);
+            bool activated = clicked && ImGui::IsMouseDoubleClicked(ImGuiMouseButton_Left);
+            ImGui::SetCursorScreenPos(cursor);
+            ImGui::PopID();
+
+            ((ImGui::TableSetColumnIndex(I), Columns::draw(row)), ...);
+
+            return activated;
+        }
+
+        bool updateSortSpecs() {
+            ImGuiTableSortSpecs *specs = ImGui::TableGetSortSpecs();
+            if (specs == nullptr || !specs->SpecsDirty) {
+                return false;
+            }
+
+            if (specs->SpecsCount > 0) {
+                const ImGuiTableColumnSortSpecs& spec = specs->Specs[0];
+                mSortColumn = std::min<size_t>(spec.ColumnUserID, kColumnCount - 1);
+                mSortDescending = spec.SortDirection == ImGuiSortDirection_Descending;
+            }
+
+            specs->SpecsDirty = false;
+            return true;
+        }
+
+        uint32_t getRowAt(size_t i) const {
+            return mRowFilter.isActive() ? mVisibleRows[i] : mSortIndices[mSortColumn].at(i, mSortDescending);
+        }
+
+        size_t getVisibleCount() const {
+            return mRowFilter.isActive() ? mVisibleRows.size() : mSortIndices[mSortColumn].size();
+        }
+
+    public:
+        /// @brief Assign each row its filter document. Called on the worker
+        ///        thread that projected @p rows, before they are published.
+        static void indexRows(std::span<Row> rows, sm::StringPool& pool, sm::TrigramIndex& index) {
+            constexpr size_t kSearchableCount = (size_t(Columns::kSearchable) + ...);
+            static_assert(kSearchableCount > 0, "at least one column must be searchable");
+
+            std::vector<sm::InternedString> documents;
+            documents.reserve(rows.size());
+
+            for (const Row& row : rows) {
+                if constexpr (kSearchableCount == 1) {
+                    ([&] {
+                        if constexpr (Columns::kSearchable) {
+                            documents.push_back(Columns::getText(row));
+                        }
+                    }(), ...);
+                } else {
+                    //
+                    // Several searchable columns are matched as one document,
+                    // separated so a query can't match across a boundary.
+                    //
+                    std::string joined;
+                    ([&] {
+                        if constexpr (Columns::kSearchable) {
+                            if (!joined.empty()) {
+                                joined += '\n';
+                            }
+                            joined += Columns::getText(row).view();
+                        }
+                    }(), ...);
+                    documents.push_back(pool.intern(joined));
+                }
+            }
+
+            uint32_t first = index.insert(documents);
+            for (size_t i = 0; i < rows.size(); ++i) {
+                rows[i].searchId = first + static_cast<uint32_t>(i);
+            }
+        }
+
+        /// @brief Forget all rows ahead of a new fetch.
+        /// @return The index the new rows should be added to with indexRows.
+        std::shared_ptr<sm::TrigramIndex> reset() {
+            for (auto& index : mSortIndices) {
+                index.clear();
+            }
+
+            mSearchText.clear();
+            mVisibleRows.clear();
+            return mRowFilter.reset();
+        }
+
+        std::string toCsv(std::span<const Row> rows) const {
+            std::string csv;
+
+            ([&] {
+                detail::appendCsvField(csv, Columns::kLabel);
+                csv += ',';
+            }(), ...);
+            csv.back() = '\n';
+
+            for (size_t i = 0; i < getVisibleCount(); ++i) {
+                const Row& row = rows[getRowAt(i)];
+                ([&] {
+                    detail::appendCsvField(csv, Columns::getText(row).view());
+                    csv += ',';
+                }(), ...);
+                csv.back() = '\n';
+            }
+
+            return csv;
+        }
+
+        /// @return The index of a row the user double clicked this frame.
+        std::optional<uint32_t> draw(const char *id, std::span<const Row> rows) {
+            updateSortIndices(rows, std::index_sequence_for<Columns...>{});
+
+            ImGui::SetNextItemWidth(ImGui::GetFontSize() * 20.f);
+            ImGui::InputTextWithHint("##Filter", "Filter", &mSearchText);
+
+            bool filterChanged = mRowFilter.update(rows, [](const Row& row) { return row.searchId; }, mSearchText);
+
+            ImGui::SameLine();
+            if (ImGui::Button("Copy CSV")) {
+                ImGui::SetClipboardText(toCsv(rows).c_str());
+            }
+
+            if (mRowFilter.isActive()) {
+                ImGui::SameLine();
+                ImGui::Text("Matched: %zu", mVisibleRows.size());
+            }
+
+            if (!ImGui::BeginTable(id, static_cast<int>(kColumnCount), mTableFlags)) {
+                return std::nullopt;
+            }
+
+            setupColumns(std::index_sequence_for<Columns...>{});
+            ImGui::TableSetupScrollFreeze(0, 1);
+            ImGui::TableHeadersRow();
+
+            bool sortChanged = updateSortSpecs();
+            if (mRowFilter.isActive() && (filterChanged || sortChanged)) {
+                mRowFilter.apply(mSortIndices[mSortColumn], mSortDescending, mVisibleRows);
+            }
+
+            //
+            // Only lay out the rows that are actually visible.
+            //
+            std::optional<uint32_t> activated;
+
+            ImGuiListClipper clipper;
+            clipper.Begin(static_cast<int>(getVisibleCount()));
+            while (clipper.Step()) {
+                for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+                    uint32_t index = getRowAt(i);
+                    ImGui::TableNextRow();
+                    if (drawRow(rows[index], index, std::index_sequence_for<Columns...>{})) {
+                        activated = index;
+                    }
+                }
+            }
+
+            ImGui::EndTable();
+
+            return activated;
+        }
+    };
+}
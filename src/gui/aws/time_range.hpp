@@ -0,0 +1,37 @@
+#pragma once
+
+#include <imgui.h>
+
+#include <chrono>
+#include <iterator>
+
+namespace ImAws {
+    struct TimeRange {
+        const char *label;
+        std::chrono::milliseconds duration;
+    };
+
+    /// @brief Relative ranges offered by the log viewers, ending now.
+    inline constexpr TimeRange kTimeRanges[] = {
+        { "Last 15 minutes", std::chrono::minutes{15} },
+        { "Last hour", std::chrono::hours{1} },
+        { "Last 6 hours", std::chrono::hours{6} },
+        { "Last day", std::chrono::hours{24} },
+        { "Last week", std::chrono::hours{24 * 7} },
+    };
+
+    /// @brief Combo box choosing an index into kTimeRanges.
+    inline bool TimeRangeCombo(const char *id, int& index) {
+        bool changed = false;
+        if (ImGui::BeginCombo(id, kTimeRanges[index].label)) {
+            for (int i = 0; i < static_cast<int>(std::size(kTimeRanges)); ++i) {
+                if (ImGui::Selectable(kTimeRanges[i].label, i == index)) {
+                    changed = i != index;
+                    index = i;
+                }
+            }
+            ImGui::EndCombo();
+        }
+        return changed;
+    }
+}
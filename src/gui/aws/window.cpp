@@ -18,6 +18,17 @@ std::string ImAws::IWindow::getSessionRegion() const {
     return mSession->getSelectedRegion();
 }
 
+ImAws::ClientContext ImAws::IWindow::getClientContext() const {
+    return ClientContext {
+        .provider = getSessionCredentialsProvider(),
+        .region = getSessionRegion(),
+    };
+}
+
+void ImAws::IWindow::openWindow(std::unique_ptr<IWindow> window) {
+    mSession->addWindow(std::move(window));
+}
+
 void ImAws::IWindow::setTitle(std::string title) {
     mTitle = std::move(title);
 }
@@ -27,11 +38,21 @@ bool ImAws::IWindow::drawWindow() {
         if (auto _ = ImAws::Begin(mTitle.c_str(), &mIsOpen)) {
             draw();
         }
+
+        if (!mIsOpen) {
+            onClose();
+        }
     }
 
     return mIsOpen;
 }
 
 bool ImAws::WindowMenuItem(IWindow& window) {
-    return ImGui::MenuItem(window.mTitle.c_str(), nullptr, &window.mIsOpen);
+    bool wasOpen = window.mIsOpen;
+    bool clicked = ImGui::MenuItem(window.mTitle.c_str(), nullptr, &window.mIsOpen);
+    if (wasOpen && !window.mIsOpen) {
+        window.onClose();
+    }
+
+    return clicked;
 }
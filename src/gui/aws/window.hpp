@@ -2,11 +2,40 @@
 
 #include "aws/core/auth/AWSCredentials.h"
 #include "aws/core/auth/AWSCredentialsProvider.h"
+#include "aws/core/client/ClientConfiguration.h"
+#include <memory>
 #include <string>
 
 namespace ImAws {
     class Session;
 
+    //
+    // Everything a worker needs to create a client, captured by value so
+    // background work never has to reach back into the window.
+    //
+    struct ClientContext {
+        std::shared_ptr<Aws::Auth::AWSCredentialsProvider> provider;
+        std::string region;
+    };
+
+    /// @param configure Called with the client configuration before the client is created.
+    template<typename Client, typename Config, typename F>
+    Client createClient(const ClientContext& context, F&& configure) {
+        Aws::Client::ClientConfigurationInitValues clientConfigInitValues;
+        clientConfigInitValues.shouldDisableIMDS = true;
+
+        Config config{clientConfigInitValues};
+        config.region = context.region;
+        configure(config);
+
+        return Client{context.provider, config};
+    }
+
+    template<typename Client, typename Config>
+    Client createClient(const ClientContext& context) {
+        return createClient<Client, Config>(context, [](Config&) { });
+    }
+
     class IWindow {
         Session *mSession;
         std::string mTitle;
@@ -19,6 +48,15 @@ namespace ImAws {
 
         std::shared_ptr<Aws::Auth::AWSCredentialsProvider> getSessionCredentialsProvider() const;
         std::string getSessionRegion() const;
+        ClientContext getClientContext() const;
+
+        Session *getSession() const { return mSession; }
+
+        /// @brief Open another window in the same session, it is shown from the next frame.
+        void openWindow(std::unique_ptr<IWindow> window);
+
+        /// @brief Called when the window is closed, cancel any background work here.
+        virtual void onClose() { }
 
     public:
         virtual ~IWindow() = default;
@@ -1,9 +1,16 @@
 #pragma once
 
 #include "gui/aws/errors.hpp"
+#include "gui/aws/paginate.hpp"
+#include "gui/aws/pages/logs.hpp"
+#include "gui/aws/table.hpp"
 #include "gui/aws/window.hpp"
-#include "gui/imaws.hpp"
+#include "gui/aws/windows/insights.hpp"
+#include "gui/aws/windows/log_events.hpp"
+#include "util/arn.hpp"
 #include "util/describe.hpp"
+#include "util/intern.hpp"
+#include "util/time.hpp"
 
 #include <imgui.h>
 
@@ -14,65 +21,82 @@ namespace ImAws {
         using LogGroup = Aws::CloudWatchLogs::Model::LogGroup;
         using CwlError = Aws::CloudWatchLogs::CloudWatchLogsError;
 
-        sm::AsyncDescribe<LogGroup, CwlError> mLogGroupDescribe;
-        sm::ErrorPanel mErrorPanel;
-
-        ImGuiTableFlags mTableFlags{ImGuiTableFlags_Resizable | ImGuiTableFlags_Reorderable | ImGuiTableFlags_Hideable | ImGuiTableFlags_BordersOuter | ImGuiTableFlags_BordersV};
-
-        Aws::CloudWatchLogs::CloudWatchLogsClient createCwlClient() {
-            auto provider = getSessionCredentialsProvider();
-
-            Aws::Client::ClientConfigurationInitValues clientConfigInitValues;
-            clientConfigInitValues.shouldDisableIMDS = true;
+        //
+        // Only the fields the table renders, projected from the SDK model
+        // on the worker thread. Strings live in mStringPool.
+        //
+        struct LogGroupRow {
+            sm::InternedString name;
+            sm::Arn arn;
+            int64_t creationTime; // unix epoch milliseconds
+            sm::InternedString creationTimeText;
+            uint32_t searchId; // document id in the table TrigramIndex
+        };
+
+        using LogGroupTable = ResourceTable<LogGroupRow,
+            TextColumn<"Name", &LogGroupRow::name>,
+            ArnColumn<"ARN", &LogGroupRow::arn>,
+            TimestampColumn<"Creation Time", &LogGroupRow::creationTime, &LogGroupRow::creationTimeText>
+        >;
+
+        //
+        // ARNs for a whole page are parsed in one batch once interned.
+        //
+        template<typename F>
+        static void projectLogGroups(const Aws::Vector<LogGroup>& logGroups, sm::StringPool& pool, sm::TrigramIndex& index, F&& add) {
+            std::vector<sm::InternedString> arnTexts;
+            arnTexts.reserve(logGroups.size());
+            for (const auto& logGroup : logGroups) {
+                arnTexts.push_back(pool.intern(logGroup.GetArn()));
+            }
 
-            Aws::CloudWatchLogs::CloudWatchLogsClientConfiguration config{clientConfigInitValues};
-            config.region = getSessionRegion();
+            std::vector<sm::Arn> arns(arnTexts.size());
+            sm::parseArns(arnTexts, arns);
+
+            std::vector<LogGroupRow> rows;
+            rows.reserve(logGroups.size());
+            for (size_t i = 0; i < logGroups.size(); ++i) {
+                const auto& logGroup = logGroups[i];
+                rows.push_back(LogGroupRow {
+                    .name = pool.intern(logGroup.GetLogGroupName()),
+                    .arn = arns[i],
+                    .creationTime = logGroup.GetCreationTime(),
+                    .creationTimeText = pool.intern(sm::formatEpochMs(logGroup.GetCreationTime())),
+                    .searchId = 0,
+                });
+            }
 
-            return Aws::CloudWatchLogs::CloudWatchLogsClient{provider, config};
-        }
+            LogGroupTable::indexRows(rows, pool, index);
 
-        std::string unix_epoch_ms_to_datetime_string(long long epochMs) {
-            std::chrono::system_clock::time_point tp{std::chrono::milliseconds{epochMs}};
-            return std::format("{0:%Y}-{0:%m}-{0:%d}:{0:%H}:{0:%M}:{0:%S}", tp);
+            for (auto& row : rows) {
+                add(std::move(row));
+            }
         }
 
-        template<typename F, typename E>
-        void fetchAllLogGroups(F&& add, E&& err, std::stop_token stop) {
-            auto cwlClient = createCwlClient();
-
-            Aws::CloudWatchLogs::Model::DescribeLogGroupsRequest request;
-            request.SetLimit(50);
-
-            Aws::String nextToken;
-            do {
-                if (!nextToken.empty()) {
-                    request.SetNextToken(nextToken);
-                }
-
-                auto outcome = cwlClient.DescribeLogGroups(request);
-                if (!outcome.IsSuccess()) {
-                    err(outcome.GetError());
-                    break;
-                }
-
-                const auto& result = outcome.GetResult();
-                for (const auto& logGroup : result.GetLogGroups()) {
-                    add(logGroup);
-                }
-
-                nextToken = result.GetNextToken();
-            } while (!nextToken.empty() && !stop.stop_requested());
-        }
-    public:
-        using IWindow::IWindow;
+        std::shared_ptr<sm::StringPool> mStringPool = std::make_shared<sm::StringPool>();
+        sm::AsyncDescribe<LogGroupRow, CwlError> mLogGroupDescribe;
+        sm::ErrorPanel mErrorPanel;
+        LogGroupTable mTable;
+        InsightsPanel mInsights;
 
-        void draw() override {
+        void drawLogGroups() {
             bool isFetching = mLogGroupDescribe.isWorking();
             ImGui::BeginDisabled(isFetching);
             if (ImGui::Button(isFetching ? "Working..." : "Fetch")) {
-                mLogGroupDescribe.run([this](auto&& add, auto&& err, std::stop_token stop) {
-                    fetchAllLogGroups(add, err, stop);
-                });
+                mStringPool = std::make_shared<sm::StringPool>();
+                mLogGroupDescribe.crawl(
+                    [context = getClientContext()](std::stop_token stop) {
+                        return sm::paginate<sm::DescribeLogGroupsPages>(context, {}, stop);
+                    },
+                    [pool = mStringPool, index = mTable.reset()](const auto& outcome, auto&& add, auto&& err) {
+                        if (!outcome.IsSuccess()) {
+                            err(outcome.GetError());
+                            return;
+                        }
+
+                        projectLogGroups(outcome.GetResult().GetLogGroups(), *pool, *index, add);
+                    }
+                );
             }
             ImGui::EndDisabled();
 
@@ -85,27 +109,42 @@ namespace ImAws {
 
             auto logGroups = mLogGroupDescribe.getItems();
 
-            if (ImGui::BeginTable("Log Groups", 3, mTableFlags)) {
-                ImGui::TableSetupColumn("Name", ImGuiTableColumnFlags_WidthStretch);
-                ImGui::TableSetupColumn("ARN", ImGuiTableColumnFlags_WidthStretch);
-                ImGui::TableSetupColumn("Creation Time", ImGuiTableColumnFlags_WidthStretch);
-                ImGui::TableHeadersRow();
-                for (const auto& group : logGroups) {
-                    ImGui::TableNextRow();
+            ImGui::SameLine();
+            ImGui::Text("Loaded: %zu (%zu queued)", logGroups.size(), mLogGroupDescribe.getPendingCount());
 
-                    ImGui::TableSetColumnIndex(0);
-                    ImGui::TextUnformatted(group.GetLogGroupName().c_str());
+            if (auto row = mTable.draw("Log Groups", logGroups)) {
+                const auto& logGroup = logGroups[*row];
+                openWindow(std::make_unique<LogEventViewer>(getSession(), std::string{logGroup.name.view()}, std::string{logGroup.arn.getText().view()}));
+            }
+        }
 
-                    ImGui::TableSetColumnIndex(1);
-                    ImAws::ArnTooltip(group.GetArn());
+    protected:
+        void onClose() override {
+            mLogGroupDescribe.cancel();
+            mInsights.cancel();
+        }
 
-                    ImGui::TableSetColumnIndex(2);
-                    auto time = unix_epoch_ms_to_datetime_string(group.GetCreationTime());
-                    ImGui::TextUnformatted(time.c_str());
-                }
+    public:
+        using IWindow::IWindow;
+
+        void draw() override {
+            if (!ImGui::BeginTabBar("Tabs")) {
+                return;
+            }
 
-                ImGui::EndTable();
+            if (ImGui::BeginTabItem("Log Groups")) {
+                drawLogGroups();
+                ImGui::EndTabItem();
             }
+
+            if (ImGui::BeginTabItem("Insights")) {
+                if (mInsights.draw()) {
+                    mInsights.run(getClientContext());
+                }
+                ImGui::EndTabItem();
+            }
+
+            ImGui::EndTabBar();
         }
     };
 }
@@ -1,9 +1,14 @@
 #pragma once
 
 #include "gui/aws/errors.hpp"
+#include "gui/aws/paginate.hpp"
+#include "gui/aws/pages/iam.hpp"
+#include "gui/aws/table.hpp"
 #include "gui/aws/window.hpp"
-#include "gui/imaws.hpp"
+#include "util/arn.hpp"
 #include "util/describe.hpp"
+#include "util/intern.hpp"
+#include "util/time.hpp"
 
 #include <imgui.h>
 
@@ -14,54 +19,66 @@ namespace ImAws {
         using Role = Aws::IAM::Model::Role;
         using IamError = Aws::IAM::IAMError;
 
-        sm::AsyncDescribe<Role, IamError> mRoleDescribe;
-        sm::ErrorPanel mErrorPanel;
-
-        ImGuiTableFlags mTableFlags{ImGuiTableFlags_Resizable | ImGuiTableFlags_Reorderable | ImGuiTableFlags_Hideable | ImGuiTableFlags_BordersOuter | ImGuiTableFlags_BordersV};
-
-        static std::string unixEpochMsToDateTimeString(long long epochMs) {
-            std::chrono::system_clock::time_point tp{std::chrono::milliseconds{epochMs}};
-            return std::format("{0:%Y}-{0:%m}-{0:%d}:{0:%H}:{0:%M}:{0:%S}", tp);
-        }
-
-        Aws::IAM::IAMClient createIamClient() {
-            auto provider = getSessionCredentialsProvider();
+        //
+        // Only the fields the table renders, projected from the SDK model
+        // on the worker thread. Strings live in mStringPool.
+        //
+        struct RoleRow {
+            sm::InternedString name;
+            sm::Arn arn;
+            int64_t createDate; // unix epoch milliseconds
+            sm::InternedString createDateText;
+            uint32_t searchId; // document id in the table TrigramIndex
+        };
+
+        using RoleTable = ResourceTable<RoleRow,
+            TextColumn<"Name", &RoleRow::name>,
+            ArnColumn<"ARN", &RoleRow::arn>,
+            TimestampColumn<"Creation Time", &RoleRow::createDate, &RoleRow::createDateText>
+        >;
+
+        //
+        // ARNs for a whole page are parsed in one batch once interned.
+        //
+        template<typename F>
+        static void projectRoles(const Aws::Vector<Role>& roles, sm::StringPool& pool, sm::TrigramIndex& index, F&& add) {
+            std::vector<sm::InternedString> arnTexts;
+            arnTexts.reserve(roles.size());
+            for (const auto& role : roles) {
+                arnTexts.push_back(pool.intern(role.GetArn()));
+            }
 
-            Aws::Client::ClientConfigurationInitValues clientConfigInitValues;
-            clientConfigInitValues.shouldDisableIMDS = true;
+            std::vector<sm::Arn> arns(arnTexts.size());
+            sm::parseArns(arnTexts, arns);
+
+            std::vector<RoleRow> rows;
+            rows.reserve(roles.size());
+            for (size_t i = 0; i < roles.size(); ++i) {
+                const auto& role = roles[i];
+                rows.push_back(RoleRow {
+                    .name = pool.intern(role.GetRoleName()),
+                    .arn = arns[i],
+                    .createDate = role.GetCreateDate().Millis(),
+                    .createDateText = pool.intern(sm::formatEpochMs(role.GetCreateDate().Millis())),
+                    .searchId = 0,
+                });
+            }
 
-            Aws::IAM::IAMClientConfiguration config{clientConfigInitValues};
-            config.region = getSessionRegion();
+            RoleTable::indexRows(rows, pool, index);
 
-            return Aws::IAM::IAMClient{provider, config};
+            for (auto& row : rows) {
+                add(std::move(row));
+            }
         }
 
-        template<typename F, typename E>
-        void fetchAllRoles(F&& add, E&& err, std::stop_token stop) {
-            auto iamClient = createIamClient();
-
-            Aws::IAM::Model::ListRolesRequest request;
-            request.SetMaxItems(50);
-
-            Aws::String marker;
-            do {
-                if (!marker.empty()) {
-                    request.SetMarker(marker);
-                }
-
-                auto outcome = iamClient.ListRoles(request);
-                if (!outcome.IsSuccess()) {
-                    err(outcome.GetError());
-                    break;
-                }
-
-                const auto& result = outcome.GetResult();
-                for (const auto& role : result.GetRoles()) {
-                    add(role);
-                }
+        std::shared_ptr<sm::StringPool> mStringPool = std::make_shared<sm::StringPool>();
+        sm::AsyncDescribe<RoleRow, IamError> mRoleDescribe;
+        sm::ErrorPanel mErrorPanel;
+        RoleTable mTable;
 
-                marker = result.GetMarker();
-            } while (!marker.empty() && !stop.stop_requested());
+    protected:
+        void onClose() override {
+            mRoleDescribe.cancel();
         }
 
     public:
@@ -71,9 +88,20 @@ namespace ImAws {
             bool isFetching = mRoleDescribe.isWorking();
             ImGui::BeginDisabled(isFetching);
             if (ImGui::Button(isFetching ? "Working..." : "Fetch")) {
-                mRoleDescribe.run([this](auto&& add, auto&& err, std::stop_token stop) {
-                    fetchAllRoles(add, err, stop);
-                });
+                mStringPool = std::make_shared<sm::StringPool>();
+                mRoleDescribe.crawl(
+                    [context = getClientContext()](std::stop_token stop) {
+                        return sm::paginate<sm::ListRolesPages>(context, {}, stop);
+                    },
+                    [pool = mStringPool, index = mTable.reset()](const auto& outcome, auto&& add, auto&& err) {
+                        if (!outcome.IsSuccess()) {
+                            err(outcome.GetError());
+                            return;
+                        }
+
+                        projectRoles(outcome.GetResult().GetRoles(), *pool, *index, add);
+                    }
+                );
             }
             ImGui::EndDisabled();
 
@@ -86,27 +114,10 @@ namespace ImAws {
 
             auto roles = mRoleDescribe.getItems();
 
-            if (ImGui::BeginTable("IAM Roles", 3, mTableFlags)) {
-                ImGui::TableSetupColumn("Name", ImGuiTableColumnFlags_WidthStretch);
-                ImGui::TableSetupColumn("ARN", ImGuiTableColumnFlags_WidthStretch);
-                ImGui::TableSetupColumn("Creation Time", ImGuiTableColumnFlags_WidthStretch);
-                ImGui::TableHeadersRow();
-                for (const auto& role : roles) {
-                    ImGui::TableNextRow();
+            ImGui::SameLine();
+            ImGui::Text("Loaded: %zu (%zu queued)", roles.size(), mRoleDescribe.getPendingCount());
 
-                    ImGui::TableSetColumnIndex(0);
-                    ImGui::TextUnformatted(role.GetRoleName().c_str());
-
-                    ImGui::TableSetColumnIndex(1);
-                    ImAws::ArnTooltip(role.GetArn());
-
-                    ImGui::TableSetColumnIndex(2);
-                    auto time = unixEpochMsToDateTimeString(role.GetCreateDate().Millis());
-                    ImGui::TextUnformatted(time.c_str());
-                }
-
-                ImGui::EndTable();
-            }
+            mTable.draw("IAM Roles", roles);
         }
     };
 }
@@ -0,0 +1,279 @@
+#include "insights.hpp"
+
+#include "gui/aws/time_range.hpp"
+
+#include <imgui.h>
+#include <implot.h>
+#include <misc/cpp/imgui_stdlib.h>
+
+#include <algorithm>
+#include <chrono>
+
+namespace {
+    // Upper bound on result columns shown in the table.
+    constexpr int kMaxTableColumns = 64;
+
+    struct ChartSeries {
+        const sm::ColumnTable *table;
+        std::span<const uint32_t> order; // rows in time order
+        size_t timeColumn;
+        size_t valueColumn;
+    };
+
+    ImPlotPoint getChartPoint(int index, void *data) {
+        const auto *series = static_cast<const ChartSeries*>(data);
+        uint32_t row = series->order[index];
+        return ImPlotPoint {
+            static_cast<double>(series->table->getTimestamps(series->timeColumn)[row]) / 1000.0,
+            series->table->getNumbers(series->valueColumn)[row],
+        };
+    }
+
+    Aws::Vector<Aws::String> splitLogGroups(std::string_view text) {
+        Aws::Vector<Aws::String> names;
+        while (!text.empty()) {
+            size_t end = text.find_first_of(",\n");
+            std::string_view name = text.substr(0, end);
+
+            size_t first = name.find_first_not_of(" \t\r");
+            size_t last = name.find_last_not_of(" \t\r");
+            if (first != std::string_view::npos) {
+                names.emplace_back(name.substr(first, last - first + 1));
+            }
+
+            text = end == std::string_view::npos ? std::string_view{} : text.substr(end + 1);
+        }
+        return names;
+    }
+}
+
+void ImAws::InsightsPanel::run(ClientContext context) {
+    auto now = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch());
+    auto start = now - std::chrono::duration_cast<std::chrono::seconds>(kTimeRanges[mTimeRange].duration);
+
+    Aws::CloudWatchLogs::Model::StartQueryRequest request;
+    request.SetQueryString(mQueryText);
+    request.SetLogGroupNames(splitLogGroups(mLogGroups));
+
+    mResults.clear();
+    mSortIndex.clear();
+    mChartOrder.clear();
+    mSortColumn = kNoColumn;
+    mChartTimeColumn = kNoColumn;
+    mChartValueColumn = kNoColumn;
+
+    mQuery.start(std::move(context), std::move(request), start.count(), now.count());
+}
+
+void ImAws::InsightsPanel::cancel() {
+    mQuery.cancel();
+}
+
+void ImAws::InsightsPanel::drawStatus() {
+    InsightsQueryStats stats = mQuery.getStats();
+
+    ImGui::Text("Rows: %zu Matched: %.0f Scanned: %.0f records, %.1f MB",
+        mResults.getRowCount(),
+        stats.recordsMatched,
+        stats.recordsScanned,
+        stats.bytesScanned / (1024.0 * 1024.0)
+    );
+
+    if (stats.windowCount > 1) {
+        ImGui::SameLine();
+        ImGui::Text("Windows: %zu/%zu done, %zu running (limit %zu)",
+            stats.finishedWindows, stats.windowCount,
+            stats.runningWindows, stats.concurrency
+        );
+    }
+
+    if (stats.truncatedWindows > 0) {
+        ImGui::SameLine();
+        if (stats.isSplittable) {
+            ImGui::TextColored(ImVec4{1.f, 0.7f, 0.2f, 1.f}, "%zu one second windows still hit the row cap", stats.truncatedWindows);
+        } else {
+            ImGui::TextColored(ImVec4{1.f, 0.7f, 0.2f, 1.f}, "Results hit the row cap, this query can't be split into shorter windows");
+        }
+    }
+}
+
+void ImAws::InsightsPanel::drawTable() {
+    int columnCount = static_cast<int>(std::min<size_t>(mResults.getColumnCount(), kMaxTableColumns));
+    if (columnCount == 0) {
+        return;
+    }
+
+    ImGuiTableFlags flags = ImGuiTableFlags_Sortable | ImGuiTableFlags_ScrollX | ImGuiTableFlags_ScrollY | ImGuiTableFlags_RowBg
+        | ImGuiTableFlags_BordersOuter | ImGuiTableFlags_BordersV | ImGuiTableFlags_Resizable | ImGuiTableFlags_Hideable;
+    if (!ImGui::BeginTable("Results", columnCount, flags)) {
+        return;
+    }
+
+    for (int i = 0; i < columnCount; ++i) {
+        ImGui::TableSetupColumn(mResults.getName(i).c_str(), ImGuiTableColumnFlags_WidthFixed, ImGui::GetFontSize() * 12.f);
+    }
+    ImGui::TableSetupScrollFreeze(0, 1);
+    ImGui::TableHeadersRow();
+
+    if (ImGuiTableSortSpecs *specs = ImGui::TableGetSortSpecs(); specs && specs->SpecsDirty) {
+        if (specs->SpecsCount > 0) {
+            mSortColumn = static_cast<size_t>(specs->Specs[0].ColumnIndex);
+            mSortDescending = specs->Specs[0].SortDirection == ImGuiSortDirection_Descending;
+        } else {
+            mSortColumn = kNoColumn;
+        }
+        mSortIndex.clear();
+        specs->SpecsDirty = false;
+    }
+
+    if (mSortColumn >= mResults.getColumnCount()) {
+        mSortColumn = kNoColumn;
+    }
+
+    //
+    // A column can lose its type as rows arrive, numbers that sorted as
+    // numbers now sort as text, so the index is rebuilt from scratch.
+    //
+    if (mSortColumn != kNoColumn) {
+        sm::ColumnKind kind = mResults.getKind(mSortColumn);
+        if (kind != mSortKind) {
+            mSortKind = kind;
+            mSortIndex.clear();
+        }
+
+        mSortIndex.update(mResults.getRowCount(), [&](uint32_t lhs, uint32_t rhs) {
+            return mResults.less(mSortColumn, lhs, rhs);
+        });
+    }
+
+    ImGuiListClipper clipper;
+    clipper.Begin(static_cast<int>(mResults.getRowCount()));
+    while (clipper.Step()) {
+        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+            size_t row = mSortColumn != kNoColumn ? mSortIndex.at(i, mSortDescending) : static_cast<size_t>(i);
+            ImGui::TableNextRow();
+
+            for (int column = 0; column < columnCount; ++column) {
+                ImGui::TableSetColumnIndex(column);
+                std::string_view text = mResults.getText(column, row);
+                ImGui::TextUnformatted(text.data(), text.data() + text.size());
+            }
+        }
+    }
+
+    ImGui::EndTable();
+}
+
+void ImAws::InsightsPanel::drawChart() {
+    auto columnCombo = [&](const char *id, sm::ColumnKind kind, size_t& selected) {
+        if (selected != kNoColumn && (selected >= mResults.getColumnCount() || mResults.getKind(selected) != kind)) {
+            selected = kNoColumn;
+        }
+
+        const char *preview = selected != kNoColumn ? mResults.getName(selected).c_str() : "";
+        if (ImGui::BeginCombo(id, preview)) {
+            for (size_t i = 0; i < mResults.getColumnCount(); ++i) {
+                if (mResults.getKind(i) == kind && ImGui::Selectable(mResults.getName(i).c_str(), i == selected)) {
+                    selected = i;
+                }
+            }
+            ImGui::EndCombo();
+        }
+    };
+
+    size_t timeColumn = mChartTimeColumn;
+
+    ImGui::SetNextItemWidth(ImGui::GetFontSize() * 10.f);
+    columnCombo("Time", sm::ColumnKind::eTimestamp, mChartTimeColumn);
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(ImGui::GetFontSize() * 10.f);
+    columnCombo("Value", sm::ColumnKind::eNumber, mChartValueColumn);
+
+    if (mChartTimeColumn != timeColumn) {
+        mChartOrder.clear();
+    }
+
+    if (mChartTimeColumn == kNoColumn || mChartValueColumn == kNoColumn) {
+        ImGui::TextUnformatted("Choose a timestamp column and a number column, such as the bin() and a stats result.");
+        return;
+    }
+
+    mChartOrder.update(mResults.getRowCount(), [&](uint32_t lhs, uint32_t rhs) {
+        return mResults.less(mChartTimeColumn, lhs, rhs);
+    });
+
+    //
+    // Rows without a timestamp sort last, leave them off the chart.
+    //
+    auto order = mChartOrder.getOrder();
+    auto timestamps = mResults.getTimestamps(mChartTimeColumn);
+    auto end = std::partition_point(order.begin(), order.end(), [&](uint32_t row) {
+        return timestamps[row] != sm::ColumnTable::kNoTimestamp;
+    });
+
+    ChartSeries series {
+        .table = &mResults,
+        .order = order.first(static_cast<size_t>(end - order.begin())),
+        .timeColumn = mChartTimeColumn,
+        .valueColumn = mChartValueColumn,
+    };
+
+    if (ImPlot::BeginPlot("##Chart", ImVec2{-1.f, -1.f})) {
+        ImPlot::SetupAxes(mResults.getName(mChartTimeColumn).c_str(), mResults.getName(mChartValueColumn).c_str(), ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+        ImPlot::SetupAxisScale(ImAxis_X1, ImPlotScale_Time);
+        ImPlot::SetNextMarkerStyle(ImPlotMarker_Circle);
+        ImPlot::PlotLineG(mResults.getName(mChartValueColumn).c_str(), getChartPoint, &series, static_cast<int>(series.order.size()));
+        ImPlot::EndPlot();
+    }
+}
+
+bool ImAws::InsightsPanel::draw() {
+    bool isWorking = mQuery.isWorking();
+    bool run = false;
+
+    ImGui::SetNextItemWidth(-FLT_MIN);
+    ImGui::InputTextWithHint("##LogGroups", "Log group names, comma separated", &mLogGroups);
+    ImGui::InputTextMultiline("##Query", &mQueryText, ImVec2{-FLT_MIN, ImGui::GetTextLineHeight() * 5.f});
+
+    ImGui::SetNextItemWidth(ImGui::GetFontSize() * 10.f);
+    TimeRangeCombo("##Range", mTimeRange);
+
+    ImGui::SameLine();
+    ImGui::BeginDisabled(isWorking || mLogGroups.empty());
+    if (ImGui::Button(isWorking ? "Running..." : "Run")) {
+        run = true;
+    }
+    ImGui::EndDisabled();
+
+    if (isWorking) {
+        ImGui::SameLine();
+        if (ImGui::Button("Stop")) {
+            mQuery.cancel();
+        }
+    }
+
+    ImGui::SameLine();
+    ImGui::Checkbox("Chart", &mShowChart);
+
+    if (mQuery.poll(mResults)) {
+        mSortIndex.clear();
+        mChartOrder.clear();
+    }
+
+    if (mQuery.hasError()) {
+        mErrorPanel.addError(mQuery.error());
+        mQuery.clear();
+    }
+
+    mErrorPanel.draw();
+
+    drawStatus();
+
+    if (mShowChart) {
+        drawChart();
+    } else {
+        drawTable();
+    }
+
+    return run;
+}
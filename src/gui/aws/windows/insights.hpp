@@ -0,0 +1,51 @@
+#pragma once
+
+#include "gui/aws/errors.hpp"
+#include "gui/aws/insights.hpp"
+#include "util/column_table.hpp"
+#include "util/sort_index.hpp"
+
+#include <string>
+
+namespace ImAws {
+    //
+    // Logs Insights query editor and result view, drawn as a tab of the
+    // CloudWatch Logs window. Long or dense ranges are split into several
+    // queries by InsightsQuery. Results are kept in a ColumnTable and shown
+    // either as a clipped table, sortable on any column by its typed values,
+    // or as a chart of a number column over a timestamp column such as the
+    // bin() of a stats query. The chart reads the columns in place.
+    //
+    class InsightsPanel {
+        static constexpr size_t kNoColumn = SIZE_MAX;
+
+        std::string mQueryText = "fields @timestamp, @message\n| sort @timestamp desc\n| limit 1000";
+        std::string mLogGroups;
+        int mTimeRange = 1;
+
+        sm::ErrorPanel mErrorPanel;
+        InsightsQuery mQuery;
+        sm::ColumnTable mResults;
+
+        size_t mSortColumn = kNoColumn;
+        sm::ColumnKind mSortKind = sm::ColumnKind::eText;
+        bool mSortDescending = false;
+        sm::SortIndex mSortIndex;
+
+        bool mShowChart = false;
+        size_t mChartTimeColumn = kNoColumn;
+        size_t mChartValueColumn = kNoColumn;
+        sm::SortIndex mChartOrder;
+
+        void drawStatus();
+        void drawTable();
+        void drawChart();
+
+    public:
+        /// @return True if the user asked to run the query.
+        bool draw();
+
+        void run(ClientContext context);
+        void cancel();
+    };
+}
@@ -0,0 +1,111 @@
+#include "live_tail.hpp"
+
+#include "gui/aws/log_table.hpp"
+
+#include <imgui.h>
+#include <misc/cpp/imgui_stdlib.h>
+
+#include <format>
+
+namespace {
+    // Upper bound on events appended to the store each frame.
+    constexpr size_t kMaxEventsPerFrame = 50'000;
+
+    constexpr ImVec4 kWarningColour{1.f, 0.7f, 0.2f, 1.f};
+}
+
+ImAws::LiveTailViewer::LiveTailViewer(Session *session, std::string logGroupName, std::string logGroupArn)
+    : IWindow(session, "Live Tail")
+    , mLogGroupName(std::move(logGroupName))
+    , mLogGroupArn(std::move(logGroupArn))
+    , mEvents(static_cast<size_t>(mMemoryCapMb) * 1024 * 1024)
+{
+    setTitle(std::format("Live Tail - {}##{}", mLogGroupName, static_cast<const void*>(this)));
+}
+
+void ImAws::LiveTailViewer::onClose() {
+    mLiveTail.cancel();
+}
+
+uint64_t ImAws::LiveTailViewer::drainEvents() {
+    uint64_t evicted = mEvents.getEvictedCount();
+
+    sm::LogChunk chunk;
+    mLiveTail.poll(chunk, kMaxEventsPerFrame);
+    mEvents.append(std::move(chunk));
+
+    return mEvents.getEvictedCount() - evicted;
+}
+
+void ImAws::LiveTailViewer::drawStatus() {
+    LiveTailStats stats = mLiveTail.getStats();
+
+    ImGui::Text("%s Received: %llu Shown: %zu (%llu evicted) Memory: %.1f MB",
+        stats.isConnected ? "Connected." : mLiveTail.isActive() ? "Connecting..." : "Stopped.",
+        static_cast<unsigned long long>(stats.receivedEvents),
+        mEvents.size(),
+        static_cast<unsigned long long>(mEvents.getEvictedCount()),
+        static_cast<double>(mEvents.getMemoryUsage()) / (1024.0 * 1024.0)
+    );
+
+    if (stats.droppedEvents > 0) {
+        ImGui::SameLine();
+        ImGui::TextColored(kWarningColour, "Dropped: %llu events in %llu updates",
+            static_cast<unsigned long long>(stats.droppedEvents),
+            static_cast<unsigned long long>(stats.droppedUpdates)
+        );
+    }
+
+    if (stats.isSampled) {
+        ImGui::SameLine();
+        ImGui::TextColored(kWarningColour, "Sampled");
+        ImGui::SetItemTooltip("CloudWatch is sending a sample of matching events because more than 500 a second match.\n"
+            "Narrow the filter pattern to see every event. %llu updates sampled so far.",
+            static_cast<unsigned long long>(stats.sampledUpdates)
+        );
+    }
+}
+
+void ImAws::LiveTailViewer::draw() {
+    bool isActive = mLiveTail.isActive();
+
+    ImGui::BeginDisabled(isActive);
+    ImGui::SetNextItemWidth(ImGui::GetFontSize() * 20.f);
+    ImGui::InputTextWithHint("##Pattern", "Filter pattern", &mFilterPattern);
+    ImGui::EndDisabled();
+
+    ImGui::SameLine();
+    if (isActive) {
+        if (ImGui::Button("Stop")) {
+            mLiveTail.cancel();
+        }
+    } else if (ImGui::Button("Start")) {
+        mEvents.clear();
+        mLiveTail.start(getClientContext(), mLogGroupArn, mFilterPattern);
+    }
+
+    ImGui::SameLine();
+    ImGui::Checkbox("Follow", &mFollowTail);
+
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(ImGui::GetFontSize() * 10.f);
+    if (ImGui::SliderInt("Memory cap (MB)", &mMemoryCapMb, 16, 1024)) {
+        mEvents.setMemoryCap(static_cast<size_t>(mMemoryCapMb) * 1024 * 1024);
+    }
+
+    uint64_t evicted = drainEvents();
+
+    if (mLiveTail.hasError()) {
+        mErrorPanel.addError(mLiveTail.error());
+        mLiveTail.clear();
+    }
+
+    mErrorPanel.draw();
+
+    drawStatus();
+
+    const auto& streams = mLiveTail.getStreams();
+    drawLogEventTable("Events", mEvents, evicted, mFollowTail, [&](uint32_t source) -> std::string_view {
+        return source < streams.size() ? std::string_view{streams[source]} : std::string_view{};
+    });
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "gui/aws/errors.hpp"
+#include "gui/aws/live_tail.hpp"
+#include "gui/aws/window.hpp"
+#include "util/log_store.hpp"
+
+namespace ImAws {
+    //
+    // Streams new events of one log group as they are ingested through a
+    // LiveTail session. Events land in a LogEventStore like the range viewer,
+    // the status line shows events dropped because the view fell behind and
+    // whether CloudWatch is sampling the session.
+    //
+    class LiveTailViewer final : public IWindow {
+        std::string mLogGroupName;
+        std::string mLogGroupArn;
+        std::string mFilterPattern;
+        bool mFollowTail = true;
+        int mMemoryCapMb = 64;
+
+        sm::ErrorPanel mErrorPanel;
+        LiveTail mLiveTail;
+        sm::LogEventStore mEvents;
+
+        /// @return The number of events evicted while draining.
+        uint64_t drainEvents();
+
+        void drawStatus();
+
+    protected:
+        void onClose() override;
+
+    public:
+        LiveTailViewer(Session *session, std::string logGroupName, std::string logGroupArn);
+
+        void draw() override;
+    };
+}
@@ -0,0 +1,831 @@
+#include "log_events.hpp"
+
+#include "gui/aws/log_table.hpp"
+#include "gui/aws/time_range.hpp"
+#include "gui/aws/windows/live_tail.hpp"
+#include "util/log_db.hpp"
+#include "util/time.hpp"
+
+#include <imgui.h>
+#include <implot.h>
+#include <misc/cpp/imgui_stdlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <format>
+
+namespace {
+    // Upper bound on merged events appended to the store each frame.
+    constexpr size_t kMaxEventsPerFrame = 100'000;
+
+    // Each shard covers about this much of the range, up to kMaxShards.
+    constexpr std::chrono::minutes kShardDuration{15};
+    constexpr size_t kMaxShards = 64;
+
+    // Local searches return at most this many events, the store's memory
+    // cap still applies on top.
+    constexpr size_t kMaxLocalResults = 500'000;
+
+    constexpr const char *kModeLabels[] = { "Range", "Tail", "Local" };
+
+    // Chart points picked by the decimator, read from the points in place.
+    struct FieldSeries {
+        std::span<const ImAws::FieldChartPoint> points;
+        const sm::MinMaxDecimator *decimator;
+    };
+
+    ImPlotPoint getFieldPoint(int index, void *data) {
+        auto *series = static_cast<FieldSeries*>(data);
+        const auto& point = series->points[series->decimator->getIndex(static_cast<size_t>(index))];
+        return ImPlotPoint{point.time, point.value};
+    }
+
+    bool FieldCombo(const char *label, const sm::LogFieldCache& fields, int& field) {
+        bool changed = false;
+        const char *preview = field < 0 ? "None" : fields.getName(static_cast<size_t>(field)).c_str();
+        if (ImGui::BeginCombo(label, preview)) {
+            if (ImGui::Selectable("None", field < 0)) {
+                changed = field >= 0;
+                field = -1;
+            }
+
+            for (size_t i = 0; i < fields.getFieldCount(); ++i) {
+                if (ImGui::Selectable(fields.getName(i).c_str(), field == static_cast<int>(i))) {
+                    changed = field != static_cast<int>(i);
+                    field = static_cast<int>(i);
+                }
+            }
+            ImGui::EndCombo();
+        }
+        return changed;
+    }
+}
+
+ImAws::LogEventViewer::LogEventViewer(Session *session, std::string logGroupName, std::string logGroupArn)
+    : IWindow(session, "Log Events")
+    , mLogGroupName(std::move(logGroupName))
+    , mLogGroupArn(std::move(logGroupArn))
+{
+    setTitle(std::format("Log Events - {}##{}", mLogGroupName, static_cast<const void*>(this)));
+}
+
+void ImAws::LogEventViewer::onClose() {
+    stop();
+}
+
+void ImAws::LogEventViewer::stop() {
+    mEventFetch.cancel();
+    mEventTail.cancel();
+    mLocalSearch.cancel();
+}
+
+void ImAws::LogEventViewer::clearEvents() {
+    mEvents.clear();
+    mVolume.clear();
+    mPatterns.clear();
+    mGrep.rewind();
+    mFields.clear();
+    mFieldRowsDirty = true;
+    mChartDirty = true;
+}
+
+void ImAws::LogEventViewer::fetchEvents() {
+    auto now = Aws::Utils::DateTime::Now().Millis();
+
+    auto start = now - kTimeRanges[mTimeRange].duration.count();
+
+    Aws::CloudWatchLogs::Model::FilterLogEventsRequest request;
+    request.SetLogGroupName(mLogGroupName);
+    if (!mFilterPattern.empty()) {
+        request.SetFilterPattern(mFilterPattern);
+    }
+
+    clearEvents();
+
+    size_t shardCount = ShardedLogFetch::getShardCount(start, now, kShardDuration, kMaxShards);
+    mEventFetch.start(getClientContext(), std::move(request), start, now, shardCount);
+}
+
+void ImAws::LogEventViewer::tailEvents() {
+    clearEvents();
+
+    mEventTail.start(getClientContext(), mLogGroupName, static_cast<size_t>(mTailStreamCount), kTimeRanges[mTimeRange].duration);
+}
+
+void ImAws::LogEventViewer::searchEvents() {
+    auto now = Aws::Utils::DateTime::Now().Millis();
+
+    clearEvents();
+
+    mLocalSearch.start(sm::LogSearchQuery {
+        .logGroup = mLogGroupName,
+        .text = mSearchText,
+        .start = now - kTimeRanges[mTimeRange].duration.count(),
+        .end = now,
+        .limit = kMaxLocalResults,
+    });
+}
+
+uint64_t ImAws::LogEventViewer::drainEvents() {
+    uint64_t evicted = mEvents.getEvictedCount();
+
+    sm::LogChunk chunk;
+    switch (mMode) {
+    case Mode::eRange:
+        mEventFetch.poll(chunk, kMaxEventsPerFrame);
+        break;
+    case Mode::eTail:
+        mEventTail.poll(chunk, kMaxEventsPerFrame);
+        break;
+    case Mode::eLocal:
+        mLocalSearch.poll(chunk);
+        break;
+    }
+
+    if (chunk.empty()) {
+        return 0;
+    }
+
+    uint64_t from = evicted + mEvents.size();
+
+    mVolume.add(chunk);
+
+    mEvents.append(std::move(chunk));
+
+    //
+    // The new events always end up in the store's last chunk, which the
+    // database and the pattern miner share rather than copy. Until both
+    // are done with it the store starts a new chunk instead of packing
+    // into it. Both get every event, even ones the store evicts soon after.
+    //
+    mNewChunks.clear();
+    mEvents.share(from, mNewChunks);
+    for (const sm::SharedLogChunk& shared : mNewChunks) {
+        if (mMode != Mode::eLocal) {
+            sm::LogDatabase::get().insert(mLogGroupName, getStreamNames(shared, from), shared, from);
+        }
+        mPatterns.add(shared, from);
+    }
+    mNewChunks.clear();
+
+    return mEvents.getEvictedCount() - evicted;
+}
+
+std::vector<std::string> ImAws::LogEventViewer::getStreamNames(const sm::SharedLogChunk& shared, uint64_t from) const {
+    // Only the names of sources in the range are copied, the rest stay empty.
+    std::vector<std::string> names;
+    for (size_t i = static_cast<size_t>(std::max(from, shared.first) - shared.first); i < shared.count; ++i) {
+        uint32_t source = shared.chunk->getSource(i);
+        if (source >= names.size()) {
+            names.resize(source + 1);
+        }
+
+        if (names[source].empty()) {
+            std::string_view name = (mMode == Mode::eTail)
+                ? (source < mEventTail.getStreamCount() ? std::string_view{mEventTail.getStream(source).name} : std::string_view{})
+                : mEventFetch.getStreamName(source);
+            names[source] = name;
+        }
+    }
+    return names;
+}
+
+bool ImAws::LogEventViewer::isFieldViewActive() const {
+    return mSortField >= 0 || (mFilterField >= 0 && !mFilterValue.empty());
+}
+
+void ImAws::LogEventViewer::applyFields() {
+    std::vector<std::string> paths;
+    for (size_t begin = 0; begin <= mFieldList.size();) {
+        size_t end = std::min(mFieldList.find(',', begin), mFieldList.size());
+        std::string_view path = std::string_view{mFieldList}.substr(begin, end - begin);
+        size_t first = path.find_first_not_of(" \t");
+        size_t last = path.find_last_not_of(" \t");
+        if (first != std::string_view::npos) {
+            paths.emplace_back(path.substr(first, last - first + 1));
+        }
+        begin = end + 1;
+    }
+
+    mFields.setFields(paths);
+    mSortField = -1;
+    mFilterField = -1;
+    mChartField = -1;
+    mFieldRowsDirty = true;
+    mChartDirty = true;
+}
+
+void ImAws::LogEventViewer::updateFieldRows() {
+    uint64_t evicted = mEvents.getEvictedCount();
+    uint64_t end = evicted + mEvents.size();
+
+    auto keep = [&](uint64_t id) {
+        if (mFilterField < 0 || mFilterValue.empty()) {
+            return true;
+        }
+
+        return mFields.getText(mEvents, id, static_cast<size_t>(mFilterField)) == mFilterValue;
+    };
+
+    //
+    // Numbers sort before text and ties fall back to event order, values
+    // come from the cache so sorting never rescans a message.
+    //
+    auto less = [&](uint64_t lhs, uint64_t rhs) {
+        if (mSortField < 0) {
+            return lhs < rhs;
+        }
+
+        size_t field = static_cast<size_t>(mSortField);
+        double lhsNumber = mFields.getNumber(mEvents, lhs, field);
+        double rhsNumber = mFields.getNumber(mEvents, rhs, field);
+        bool lhsIsNumber = !std::isnan(lhsNumber);
+        bool rhsIsNumber = !std::isnan(rhsNumber);
+
+        if (lhsIsNumber != rhsIsNumber) {
+            return lhsIsNumber;
+        }
+
+        if (lhsIsNumber && lhsNumber != rhsNumber) {
+            return mSortDescending ? lhsNumber > rhsNumber : lhsNumber < rhsNumber;
+        }
+
+        if (!lhsIsNumber) {
+            std::string_view lhsText = mFields.getText(mEvents, lhs, field);
+            std::string_view rhsText = mFields.getText(mEvents, rhs, field);
+            if (lhsText != rhsText) {
+                return mSortDescending ? lhsText > rhsText : lhsText < rhsText;
+            }
+        }
+
+        return lhs < rhs;
+    };
+
+    if (mGrep.isActive() != mFieldRowsFromGrep || mGrep.getGeneration() != mFieldRowsGrep) {
+        mFieldRowsFromGrep = mGrep.isActive();
+        mFieldRowsGrep = mGrep.getGeneration();
+        mFieldRowsDirty = true;
+    }
+
+    if (mFieldRowsFromGrep) {
+        //
+        // Matches land out of order as chunks finish, but each poll only
+        // adds to them. Sort those added and merge them in.
+        //
+        std::span<const uint64_t> added = mGrep.getAdded();
+        if (mFieldRowsDirty) {
+            added = mGrep.getMatches();
+            mFieldRows.clear();
+        }
+
+        if (evicted != mFieldRowsEvicted) {
+            std::erase_if(mFieldRows, [&](uint64_t id) { return id < evicted; });
+        }
+
+        size_t middle = mFieldRows.size();
+        for (uint64_t id : added) {
+            if (keep(id)) {
+                mFieldRows.push_back(id);
+            }
+        }
+
+        std::sort(mFieldRows.begin() + middle, mFieldRows.end(), less);
+        std::inplace_merge(mFieldRows.begin(), mFieldRows.begin() + middle, mFieldRows.end(), less);
+    } else {
+        // New events only ever arrive at the end, sort those and merge them in.
+        if (mFieldRowsDirty) {
+            mFieldRows.clear();
+            mFieldRowsEnd = evicted;
+        }
+
+        if (evicted != mFieldRowsEvicted) {
+            std::erase_if(mFieldRows, [&](uint64_t id) { return id < evicted; });
+        }
+
+        size_t middle = mFieldRows.size();
+        for (uint64_t id = std::max(mFieldRowsEnd, evicted); id < end; ++id) {
+            if (keep(id)) {
+                mFieldRows.push_back(id);
+            }
+        }
+
+        std::sort(mFieldRows.begin() + middle, mFieldRows.end(), less);
+        std::inplace_merge(mFieldRows.begin(), mFieldRows.begin() + middle, mFieldRows.end(), less);
+        mFieldRowsEnd = end;
+    }
+
+    mFieldRowsEvicted = evicted;
+    mFieldRowsDirty = false;
+}
+
+void ImAws::LogEventViewer::updateChartPoints() {
+    uint64_t evicted = mEvents.getEvictedCount();
+    uint64_t end = evicted + mEvents.size();
+    size_t field = static_cast<size_t>(mChartField);
+
+    if (mGrep.isActive() != mChartFromGrep || mGrep.getGeneration() != mChartGrep) {
+        mChartFromGrep = mGrep.isActive();
+        mChartGrep = mGrep.getGeneration();
+        mChartDirty = true;
+    }
+
+    if (mChartDirty) {
+        mChartPoints.clear();
+        mChartEnd = evicted;
+        mChartVersion += 1;
+    }
+
+    bool isEvicted = evicted != mChartEvicted;
+    if (isEvicted) {
+        std::erase_if(mChartPoints, [&](const FieldChartPoint& point) { return point.id < evicted; });
+        mChartVersion += 1;
+    }
+
+    //
+    // Only events, or matches, added since the last frame are looked at.
+    // Each is scanned once here and its value kept, drawing never goes
+    // back to the store.
+    //
+    size_t middle = mChartPoints.size();
+    auto add = [&](uint64_t id) {
+        if (mFilterField >= 0 && !mFilterValue.empty() && mFields.getText(mEvents, id, static_cast<size_t>(mFilterField)) != mFilterValue) {
+            return;
+        }
+
+        double value = mFields.getNumber(mEvents, id, field);
+        if (std::isnan(value)) {
+            return;
+        }
+
+        double time = static_cast<double>(mEvents.at(static_cast<size_t>(id - evicted)).timestamp) / 1000.0;
+        mChartPoints.push_back(FieldChartPoint{time, value, id});
+    };
+
+    if (mChartFromGrep) {
+        for (uint64_t id : mChartDirty ? mGrep.getMatches() : mGrep.getAdded()) {
+            add(id);
+        }
+    } else {
+        for (uint64_t id = std::max(mChartEnd, evicted); id < end; ++id) {
+            add(id);
+        }
+        mChartEnd = end;
+    }
+
+    // Events are stored about in time order, so this is mostly an append.
+    auto byTime = [](const FieldChartPoint& lhs, const FieldChartPoint& rhs) {
+        return lhs.time < rhs.time;
+    };
+
+    if (middle != mChartPoints.size()) {
+        std::sort(mChartPoints.begin() + static_cast<ptrdiff_t>(middle), mChartPoints.end(), byTime);
+        std::inplace_merge(mChartPoints.begin(), mChartPoints.begin() + static_cast<ptrdiff_t>(middle), mChartPoints.end(), byTime);
+        mChartVersion += 1;
+    }
+
+    // Bounds only need a full pass when points were dropped.
+    if (mChartDirty || isEvicted) {
+        middle = 0;
+        mChartLow = INFINITY;
+        mChartHigh = -INFINITY;
+    }
+
+    for (size_t i = middle; i < mChartPoints.size(); ++i) {
+        mChartLow = std::min(mChartLow, mChartPoints[i].value);
+        mChartHigh = std::max(mChartHigh, mChartPoints[i].value);
+    }
+
+    mChartEvicted = evicted;
+    mChartDirty = false;
+}
+
+void ImAws::LogEventViewer::drawFields() {
+    ImGui::SetNextItemWidth(ImGui::GetFontSize() * 20.f);
+    if (ImGui::InputTextWithHint("##Fields", "JSON fields, e.g. level, http.status", &mFieldList, ImGuiInputTextFlags_EnterReturnsTrue)) {
+        applyFields();
+    }
+
+    if (mFields.empty()) {
+        return;
+    }
+
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(ImGui::GetFontSize() * 8.f);
+    mFieldRowsDirty |= FieldCombo("Sort", mFields, mSortField);
+
+    ImGui::SameLine();
+    mFieldRowsDirty |= ImGui::Checkbox("Descending", &mSortDescending);
+
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(ImGui::GetFontSize() * 8.f);
+    bool isFilterChanged = FieldCombo("Where", mFields, mFilterField);
+
+    if (mFilterField >= 0) {
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(ImGui::GetFontSize() * 10.f);
+        isFilterChanged |= ImGui::InputTextWithHint("##FilterValue", "equals", &mFilterValue);
+    }
+
+    mFieldRowsDirty |= isFilterChanged;
+    mChartDirty |= isFilterChanged;
+
+    ImGui::SameLine();
+    ImGui::TextDisabled("%llu scanned", static_cast<unsigned long long>(mFields.getScanCount()));
+}
+
+void ImAws::LogEventViewer::drawFieldChart() {
+    if (mFields.empty() || !ImGui::CollapsingHeader("Field Chart")) {
+        return;
+    }
+
+    ImGui::SetNextItemWidth(ImGui::GetFontSize() * 10.f);
+    mChartDirty |= FieldCombo("Value", mFields, mChartField);
+
+    if (mChartField < 0) {
+        return;
+    }
+
+    const char *name = mFields.getName(static_cast<size_t>(mChartField)).c_str();
+
+    if (!ImPlot::BeginPlot("##FieldChart", ImVec2{-1.f, ImGui::GetFontSize() * 16.f})) {
+        return;
+    }
+
+    ImPlot::SetupAxes("Time", name, ImPlotAxisFlags_None, ImPlotAxisFlags_None);
+    ImPlot::SetupAxisScale(ImAxis_X1, ImPlotScale_Time);
+
+    //
+    // ImPlot would fit to the decimated points only, fit to every point
+    // instead. The points are sorted by time and their value bounds are
+    // kept as they are added.
+    //
+    if (!mChartPoints.empty()) {
+        double pad = (mChartHigh > mChartLow) ? (mChartHigh - mChartLow) * 0.05 : std::max(std::abs(mChartHigh) * 0.05, 1.0);
+        ImPlot::SetupAxesLimits(mChartPoints.front().time, mChartPoints.back().time, mChartLow - pad, mChartHigh + pad, ImPlotCond_Always);
+    }
+
+    ImPlotRect limits = ImPlot::GetPlotLimits();
+    int pixels = static_cast<int>(ImPlot::GetPlotSize().x);
+
+    mChartDecimator.update(limits.X.Min, limits.X.Max, pixels, mChartPoints.size(), mChartVersion,
+        [&](size_t i) { return mChartPoints[i].time; },
+        [&](size_t i) { return mChartPoints[i].value; }
+    );
+
+    FieldSeries series{mChartPoints, &mChartDecimator};
+    ImPlot::PlotScatterG(name, getFieldPoint, &series, static_cast<int>(mChartDecimator.size()));
+    ImPlot::EndPlot();
+}
+
+void ImAws::LogEventViewer::drawVolume() {
+    if (mVolume.empty() || !ImGui::CollapsingHeader("Volume")) {
+        return;
+    }
+
+    ImGui::Checkbox("Bytes", &mShowVolumeBytes);
+    ImGui::SameLine();
+    ImGui::Text("%llu events, %.1f MB",
+        static_cast<unsigned long long>(mVolume.getTotalEvents()),
+        static_cast<double>(mVolume.getTotalBytes()) / (1024.0 * 1024.0)
+    );
+
+    if (!ImPlot::BeginPlot("##Volume", ImVec2{-1.f, ImGui::GetFontSize() * 10.f})) {
+        return;
+    }
+
+    ImPlot::SetupAxes("Time", mShowVolumeBytes ? "Bytes" : "Events", ImPlotAxisFlags_None, ImPlotAxisFlags_AutoFit);
+    ImPlot::SetupAxisScale(ImAxis_X1, ImPlotScale_Time);
+    ImPlot::SetupAxisLimits(ImAxis_X1, mVolume.getStart(), mVolume.getEnd(), ImPlotCond_Once);
+
+    //
+    // Only the buckets of one level that fall in view are drawn, at most
+    // about one per pixel, straight from the histogram's arrays.
+    //
+    ImPlotRect limits = ImPlot::GetPlotLimits();
+    size_t maxBuckets = static_cast<size_t>(std::max(ImPlot::GetPlotSize().x, 1.f));
+    sm::VolumeHistogramView view = mVolume.getView(limits.X.Min, limits.X.Max, maxBuckets);
+
+    if (view.size > 0) {
+        int count = static_cast<int>(view.size);
+        if (mShowVolumeBytes) {
+            ImPlot::PlotStairs("Bytes", view.bytes, count, view.width, view.start, ImPlotStairsFlags_Shaded);
+        } else {
+            ImPlot::PlotStairs("Events", view.events, count, view.width, view.start, ImPlotStairsFlags_Shaded);
+        }
+    }
+
+    ImPlot::EndPlot();
+}
+
+void ImAws::LogEventViewer::drawGrep() {
+    bool changed = false;
+
+    ImGui::SetNextItemWidth(ImGui::GetFontSize() * 20.f);
+    changed |= ImGui::InputTextWithHint("##Grep", "Search loaded events", &mGrepOptions.pattern);
+
+    ImGui::SameLine();
+    changed |= ImGui::Checkbox("Regex", &mGrepOptions.isRegex);
+
+    ImGui::SameLine();
+    changed |= ImGui::Checkbox("Ignore case", &mGrepOptions.ignoreCase);
+
+    if (changed) {
+        mGrep.start(mGrepOptions);
+    }
+
+    if (mGrep.hasError()) {
+        ImGui::SameLine();
+        ImGui::TextUnformatted(mGrep.error().c_str());
+    } else if (mGrep.isActive()) {
+        ImGui::SameLine();
+        ImGui::Text("%zu matches, %llu/%zu searched",
+            mGrep.getMatches().size(),
+            static_cast<unsigned long long>(mGrep.getSearchedCount()),
+            mEvents.size()
+        );
+
+        if (mGrep.getLiteral().empty()) {
+            ImGui::SameLine();
+            ImGui::TextDisabled("(no literal to prefilter)");
+        }
+    }
+}
+
+void ImAws::LogEventViewer::drawStreamTable() {
+    if (mEventTail.getStreamCount() == 0 || !ImGui::CollapsingHeader("Streams")) {
+        return;
+    }
+
+    ImGuiTableFlags flags = ImGuiTableFlags_ScrollY | ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersOuter | ImGuiTableFlags_BordersV | ImGuiTableFlags_Resizable;
+    ImVec2 size{0.f, ImGui::GetTextLineHeightWithSpacing() * 8.f};
+    if (!ImGui::BeginTable("Streams", 4, flags, size)) {
+        return;
+    }
+
+    ImGui::TableSetupColumn("Stream", ImGuiTableColumnFlags_WidthStretch);
+    ImGui::TableSetupColumn("Last Event", ImGuiTableColumnFlags_WidthFixed, ImGui::GetFontSize() * 12.f);
+    ImGui::TableSetupColumn("Events", ImGuiTableColumnFlags_WidthFixed, ImGui::GetFontSize() * 6.f);
+    ImGui::TableSetupColumn("State", ImGuiTableColumnFlags_WidthFixed, ImGui::GetFontSize() * 6.f);
+    ImGui::TableSetupScrollFreeze(0, 1);
+    ImGui::TableHeadersRow();
+
+    for (size_t i = 0; i < mEventTail.getStreamCount(); ++i) {
+        const LogStreamInfo& stream = mEventTail.getStream(i);
+        ImGui::TableNextRow();
+
+        ImGui::TableSetColumnIndex(0);
+        ImGui::TextUnformatted(stream.name.data(), stream.name.data() + stream.name.size());
+
+        ImGui::TableSetColumnIndex(1);
+        std::string time = sm::formatEpochMs(stream.lastEventTime);
+        ImGui::TextUnformatted(time.data(), time.data() + time.size());
+
+        ImGui::TableSetColumnIndex(2);
+        ImGui::Text("%zu", stream.eventCount);
+
+        ImGui::TableSetColumnIndex(3);
+        ImGui::TextUnformatted(stream.isCaughtUp ? "Caught up" : "Reading");
+    }
+
+    ImGui::EndTable();
+}
+
+void ImAws::LogEventViewer::drawEventTable(uint64_t evicted) {
+    LogSourceName sourceName;
+    if (mMode == Mode::eTail) {
+        sourceName = [this](uint32_t source) -> std::string_view {
+            return source < mEventTail.getStreamCount() ? mEventTail.getStream(source).name : std::string_view{};
+        };
+    }
+
+    sm::LogFieldCache *fields = mFields.empty() ? nullptr : &mFields;
+
+    if (isFieldViewActive()) {
+        // A sorted view has no stable bottom to follow.
+        drawLogEventTable("Events", mEvents, mFieldRows, 0, mFollowTail && mSortField < 0, sourceName, fields);
+    } else if (mGrep.isActive()) {
+        drawLogEventTable("Events", mEvents, mGrep.getMatches(), mGrepRemoved, mFollowTail, sourceName, fields);
+    } else {
+        drawLogEventTable("Events", mEvents, evicted, mFollowTail, sourceName, fields);
+    }
+}
+
+void ImAws::LogEventViewer::drawPatternTable() {
+    std::span<const sm::LogPattern> patterns = mPatterns.getPatterns();
+    uint64_t backlog = mPatterns.getBacklog();
+
+    ImGui::Text("%zu patterns", patterns.size());
+    if (backlog > 0) {
+        ImGui::SameLine();
+        ImGui::TextDisabled("(%llu events left to group)", static_cast<unsigned long long>(backlog));
+    }
+
+    uint64_t total = 0;
+    mPatternOrder.resize(patterns.size());
+    for (uint32_t i = 0; i < patterns.size(); ++i) {
+        mPatternOrder[i] = i;
+        total += patterns[i].events;
+    }
+
+    std::sort(mPatternOrder.begin(), mPatternOrder.end(), [&](uint32_t lhs, uint32_t rhs) {
+        return patterns[lhs].events > patterns[rhs].events;
+    });
+
+    ImGuiTableFlags flags = ImGuiTableFlags_ScrollY | ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersOuter | ImGuiTableFlags_BordersV | ImGuiTableFlags_Resizable;
+    if (!ImGui::BeginTable("Patterns", 4, flags)) {
+        return;
+    }
+
+    ImGui::TableSetupColumn("Events", ImGuiTableColumnFlags_WidthFixed, ImGui::GetFontSize() * 6.f);
+    ImGui::TableSetupColumn("Share", ImGuiTableColumnFlags_WidthFixed, ImGui::GetFontSize() * 4.f);
+    ImGui::TableSetupColumn("Bytes", ImGuiTableColumnFlags_WidthFixed, ImGui::GetFontSize() * 6.f);
+    ImGui::TableSetupColumn("Pattern", ImGuiTableColumnFlags_WidthStretch);
+    ImGui::TableSetupScrollFreeze(0, 1);
+    ImGui::TableHeadersRow();
+
+    ImGuiListClipper clipper;
+    clipper.Begin(static_cast<int>(mPatternOrder.size()));
+    while (clipper.Step()) {
+        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+            const sm::LogPattern& pattern = patterns[mPatternOrder[i]];
+            ImGui::TableNextRow();
+
+            ImGui::TableSetColumnIndex(0);
+            ImGui::Text("%llu", static_cast<unsigned long long>(pattern.events));
+
+            ImGui::TableSetColumnIndex(1);
+            ImGui::Text("%.1f%%", total > 0 ? 100.0 * static_cast<double>(pattern.events) / static_cast<double>(total) : 0.0);
+
+            ImGui::TableSetColumnIndex(2);
+            ImGui::Text("%.1f KB", static_cast<double>(pattern.bytes) / 1024.0);
+
+            ImGui::TableSetColumnIndex(3);
+            ImGui::TextUnformatted(pattern.text.data(), pattern.text.data() + pattern.text.size());
+        }
+    }
+
+    ImGui::EndTable();
+}
+
+void ImAws::LogEventViewer::draw() {
+    bool isFetching = false;
+    switch (mMode) {
+    case Mode::eRange: isFetching = mEventFetch.isWorking(); break;
+    case Mode::eTail: isFetching = mEventTail.isActive(); break;
+    case Mode::eLocal: isFetching = mLocalSearch.isWorking(); break;
+    }
+
+    ImGui::SetNextItemWidth(ImGui::GetFontSize() * 6.f);
+    if (ImGui::BeginCombo("##Mode", kModeLabels[static_cast<int>(mMode)])) {
+        for (int i = 0; i < static_cast<int>(std::size(kModeLabels)); ++i) {
+            if (ImGui::Selectable(kModeLabels[i], i == static_cast<int>(mMode)) && i != static_cast<int>(mMode)) {
+                stop();
+                mMode = static_cast<Mode>(i);
+                isFetching = false;
+            }
+        }
+        ImGui::EndCombo();
+    }
+
+    ImGui::SameLine();
+    switch (mMode) {
+    case Mode::eRange:
+        ImGui::SetNextItemWidth(ImGui::GetFontSize() * 20.f);
+        ImGui::InputTextWithHint("##Pattern", "Filter pattern", &mFilterPattern);
+        break;
+    case Mode::eTail:
+        // GetLogEvents has no filter pattern, tail mode picks streams instead.
+        ImGui::SetNextItemWidth(ImGui::GetFontSize() * 10.f);
+        ImGui::SliderInt("Streams", &mTailStreamCount, 1, 100);
+        break;
+    case Mode::eLocal:
+        ImGui::SetNextItemWidth(ImGui::GetFontSize() * 20.f);
+        ImGui::InputTextWithHint("##Search", "Words to match", &mSearchText);
+        break;
+    }
+
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(ImGui::GetFontSize() * 10.f);
+    TimeRangeCombo("##Range", mTimeRange);
+
+    ImGui::SameLine();
+    ImGui::BeginDisabled(isFetching);
+    constexpr const char *kStartLabels[] = { "Fetch", "Tail", "Search" };
+    if (ImGui::Button(isFetching ? "Working..." : kStartLabels[static_cast<int>(mMode)])) {
+        switch (mMode) {
+        case Mode::eRange: fetchEvents(); break;
+        case Mode::eTail: tailEvents(); break;
+        case Mode::eLocal: searchEvents(); break;
+        }
+    }
+    ImGui::EndDisabled();
+
+    if (isFetching) {
+        ImGui::SameLine();
+        if (ImGui::Button("Stop")) {
+            stop();
+        }
+    }
+
+    ImGui::SameLine();
+    ImGui::Checkbox("Follow", &mFollowTail);
+
+    ImGui::SameLine();
+    if (ImGui::Button("Live Tail")) {
+        openWindow(std::make_unique<LiveTailViewer>(getSession(), mLogGroupName, mLogGroupArn));
+    }
+
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(ImGui::GetFontSize() * 10.f);
+    if (ImGui::SliderInt("Memory cap (MB)", &mMemoryCapMb, 16, 4096)) {
+        mEvents.setMemoryCap(static_cast<size_t>(mMemoryCapMb) * 1024 * 1024);
+    }
+
+    if (mEventFetch.hasError()) {
+        mErrorPanel.addError(mEventFetch.error());
+        mEventFetch.clear();
+    }
+
+    if (mEventTail.hasError()) {
+        mErrorPanel.addError(mEventTail.error());
+        mEventTail.clear();
+    }
+
+    mErrorPanel.draw();
+
+    if (mLocalSearch.hasError()) {
+        ImGui::TextWrapped("Local search failed: %s", mLocalSearch.error().c_str());
+    }
+
+    uint64_t evicted = drainEvents();
+
+    ShardedLogFetchStats stats = mEventFetch.getStats();
+
+    ImGui::Text("Events: %zu (%llu evicted) Memory: %.1f MB",
+        mEvents.size(),
+        static_cast<unsigned long long>(mEvents.getEvictedCount()),
+        static_cast<double>(mEvents.getMemoryUsage()) / (1024.0 * 1024.0)
+    );
+
+    if (mMode == Mode::eLocal) {
+        sm::LogDatabase& database = sm::LogDatabase::get();
+        sm::LogDatabaseStats databaseStats = database.getStats();
+        ImGui::SameLine();
+        ImGui::Text("Searched in %.2f ms (%s), %llu events stored this session, %llu pending",
+            static_cast<double>(mLocalSearch.getElapsed().count()) / 1000.0,
+            database.hasFullTextSearch() ? "FTS5" : "scan",
+            static_cast<unsigned long long>(databaseStats.insertedEvents),
+            static_cast<unsigned long long>(databaseStats.pendingEvents)
+        );
+    } else if (mMode == Mode::eTail && mEventTail.getStreamCount() > 0) {
+        ImGui::SameLine();
+        ImGui::Text("Streams: %zu (limit %zu), %zu throttled, %zu buffered",
+            mEventTail.getStreamCount(), mEventTail.getConcurrency(),
+            mEventTail.getThrottleCount(), mEventTail.getBufferedCount()
+        );
+    } else if (stats.shardCount > 0) {
+        ImGui::SameLine();
+        ImGui::Text("Shards: %zu/%zu done, %zu running (limit %zu), %zu throttled, %zu buffered",
+            stats.finishedShards, stats.shardCount,
+            stats.runningShards, stats.concurrency,
+            stats.throttleCount, stats.bufferedEvents
+        );
+    }
+
+    if (mMode == Mode::eTail) {
+        drawStreamTable();
+    }
+
+    drawVolume();
+    drawGrep();
+    drawFields();
+
+    mGrepRemoved = mGrep.poll(mEvents);
+    if (isFieldViewActive()) {
+        updateFieldRows();
+    }
+
+    // Kept up to date while collapsed too, the grep's added matches are only there for one frame.
+    if (mChartField >= 0) {
+        updateChartPoints();
+    }
+
+    drawFieldChart();
+
+    mPatterns.poll();
+
+    if (ImGui::BeginTabBar("Views")) {
+        if (ImGui::BeginTabItem("Events")) {
+            drawEventTable(evicted);
+            ImGui::EndTabItem();
+        }
+
+        if (ImGui::BeginTabItem("Patterns")) {
+            drawPatternTable();
+            ImGui::EndTabItem();
+        }
+
+        ImGui::EndTabBar();
+    }
+}
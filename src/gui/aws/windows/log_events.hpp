@@ -0,0 +1,151 @@
+#pragma once
+
+#include "gui/aws/errors.hpp"
+#include "gui/aws/log_fetch.hpp"
+#include "gui/aws/log_search.hpp"
+#include "gui/aws/log_tail.hpp"
+#include "gui/aws/window.hpp"
+#include "util/decimate.hpp"
+#include "util/log_fields.hpp"
+#include "util/log_grep.hpp"
+#include "util/log_patterns.hpp"
+#include "util/log_store.hpp"
+#include "util/volume_histogram.hpp"
+
+#include <aws/logs/CloudWatchLogsClient.h>
+
+namespace ImAws {
+    struct FieldChartPoint {
+        double time; // unix epoch seconds
+        double value;
+        uint64_t id;
+    };
+
+    //
+    // Shows the events of one log group. The time range is fetched in
+    // parallel shards by a ShardedLogFetch, events are packed into LogChunks
+    // on the workers and appended in order to a LogEventStore, which bounds
+    // memory by evicting the oldest events.
+    //
+    // In tail mode the most recently written streams are followed instead
+    // by a LogStreamTail, which merges them into the same store.
+    //
+    // Everything fetched is also written to the LogDatabase. Local mode
+    // searches that copy instead of CloudWatch, so repeating a search over
+    // events already seen costs no API calls.
+    //
+    // Events already loaded can be narrowed further with a LogGrep, which
+    // searches the store on the worker pool and keeps up as events arrive.
+    //
+    // JSON fields named by the user are shown as extra columns and can be
+    // sorted, filtered on and charted. Each message is scanned for them at
+    // most once, by a LogFieldCache. The sorted rows and the chart points
+    // are both kept up to date by merging in the events, or grep matches,
+    // added since the last frame. The chart is drawn through a
+    // MinMaxDecimator, so it costs about two points per pixel.
+    //
+    // Event volume over time is binned into a VolumeHistogram as chunks are
+    // drained, before the store can evict them, so it covers every event
+    // received since the last fetch.
+    //
+    // A LogPatternMiner groups messages into templates on the worker pool.
+    // It is handed each chunk as it is drained, like the histogram, so the
+    // Patterns tab counts every event received.
+    //
+    class LogEventViewer final : public IWindow {
+        enum class Mode {
+            eRange,
+            eTail,
+            eLocal,
+        };
+
+        std::string mLogGroupName;
+        std::string mLogGroupArn;
+        std::string mFilterPattern;
+        std::string mSearchText;
+        Mode mMode = Mode::eRange;
+        int mTimeRange = 1;
+        int mTailStreamCount = 20;
+        int mMemoryCapMb = static_cast<int>(sm::LogEventStore::kDefaultMemoryCap / (1024 * 1024));
+        bool mFollowTail = true;
+
+        sm::GrepOptions mGrepOptions;
+        sm::LogGrep mGrep;
+        size_t mGrepRemoved = 0; // matches dropped by the last poll
+
+        std::string mFieldList;
+        sm::LogFieldCache mFields;
+        int mSortField = -1;
+        bool mSortDescending = false;
+        int mFilterField = -1;
+        std::string mFilterValue;
+        int mChartField = -1;
+
+        // Event ids after the field filter and sort, used while either is set.
+        std::vector<uint64_t> mFieldRows;
+        uint64_t mFieldRowsEnd = 0; // events before this id have been considered
+        uint64_t mFieldRowsEvicted = 0;
+        uint32_t mFieldRowsGrep = 0; // grep generation the rows were built from
+        bool mFieldRowsFromGrep = false;
+        bool mFieldRowsDirty = true;
+
+        // Numeric values of the chart field after the field filter, by time.
+        std::vector<FieldChartPoint> mChartPoints;
+        uint64_t mChartEnd = 0; // events before this id have been considered
+        uint64_t mChartEvicted = 0;
+        uint64_t mChartVersion = 0; // bumped whenever points are dropped or inserted
+        uint32_t mChartGrep = 0;
+        bool mChartFromGrep = false;
+        bool mChartDirty = true;
+        double mChartLow = 0.0;
+        double mChartHigh = 0.0;
+        sm::MinMaxDecimator mChartDecimator;
+
+        sm::ErrorPanel mErrorPanel;
+        ShardedLogFetch mEventFetch;
+        LogStreamTail mEventTail;
+        LocalLogSearch mLocalSearch;
+        sm::LogEventStore mEvents;
+        std::vector<sm::SharedLogChunk> mNewChunks; // shared with the database and the miner
+        sm::VolumeHistogram mVolume;
+        bool mShowVolumeBytes = false;
+
+        sm::LogPatternMiner mPatterns;
+        std::vector<uint32_t> mPatternOrder;
+
+        void fetchEvents();
+        void tailEvents();
+        void searchEvents();
+        void stop();
+
+        /// @return The number of events evicted while draining.
+        uint64_t drainEvents();
+
+        /// @brief Names of the log streams of events in @p shared from id
+        ///        @p from on, indexed by event source.
+        std::vector<std::string> getStreamNames(const sm::SharedLogChunk& shared, uint64_t from) const;
+
+        void clearEvents();
+
+        bool isFieldViewActive() const;
+        void applyFields();
+        void updateFieldRows();
+        void updateChartPoints();
+
+        void drawGrep();
+        void drawFields();
+        void drawFieldChart();
+        void drawVolume();
+        void drawStreamTable();
+        void drawEventTable(uint64_t evicted);
+        void drawPatternTable();
+
+    protected:
+        void onClose() override;
+
+    public:
+        LogEventViewer(Session *session, std::string logGroupName, std::string logGroupArn);
+
+        void draw() override;
+    };
+}
@@ -1,15 +1,19 @@
 #include "monitoring.hpp"
 
+#include "gui/aws/paginate.hpp"
+#include "gui/aws/pages/monitoring.hpp"
+#include "gui/aws/session.hpp"
 #include "gui/imaws.hpp"
 
 #include <aws/monitoring/model/MetricStat.h>
-#include <aws/monitoring/model/GetMetricDataRequest.h>
-#include <aws/monitoring/model/MetricDataQuery.h>
 #include <aws/monitoring/model/StandardUnit.h>
 
 #include <imgui.h>
 #include <implot.h>
 
+#include <algorithm>
+#include <cmath>
+#include <format>
 #include <print>
 
 static constexpr ImGuiTreeNodeFlags kDefaultFlags
@@ -19,91 +23,149 @@ static constexpr ImGuiTreeNodeFlags kDefaultFlags
     | ImGuiTreeNodeFlags_SpanFullWidth
     | ImGuiTreeNodeFlags_DrawLinesToNodes;
 
+static constexpr int kPeriod = 300;
+static constexpr const char *kStat = "Average";
+static constexpr int64_t kHistoryMillis = 3600ll * 1000 * 24 * 3; // 3 days
+
 static bool NextTreeNode(const char *label, ImGuiTreeNodeFlags flags) {
     ImGui::TableNextRow();
     ImGui::TableNextColumn();
     return ImGui::TreeNodeEx(label, flags);
 }
 
-Aws::CloudWatch::CloudWatchClient ImAws::MonitoringPanel::createCloudWatchClient() {
-    auto provider = getSessionCredentialsProvider();
+// Names a series by everything that identifies what it measures.
+static std::string GetSeriesKey(const Aws::CloudWatch::Model::Metric& metric) {
+    std::string key = std::format("{}/{}", metric.GetNamespace(), metric.GetMetricName());
+    for (const auto& dimension : metric.GetDimensions()) {
+        key += std::format(",{}={}", dimension.GetName(), dimension.GetValue());
+    }
+    return key + std::format(":{}:{}", kStat, kPeriod);
+}
 
-    Aws::Client::ClientConfigurationInitValues clientConfigInitValues;
-    clientConfigInitValues.shouldDisableIMDS = true;
+static std::string GetDimensionsLabel(const Aws::CloudWatch::Model::Metric& metric) {
+    std::string label;
+    for (const auto& dimension : metric.GetDimensions()) {
+        label += std::format("{}{}={}", label.empty() ? "" : ", ", dimension.GetName(), dimension.GetValue());
+    }
+    return label.empty() ? "(no dimensions)" : label;
+}
 
-    Aws::CloudWatch::CloudWatchClientConfiguration config{clientConfigInitValues};
-    config.region = getSessionRegion();
+// Points picked by the decimator, read from the series in place.
+struct SeriesPlot {
+    const sm::TimeSeries *series;
+    const sm::MinMaxDecimator *decimator;
+};
+
+static ImPlotPoint GetSeriesPoint(int index, void *data) {
+    auto *plot = static_cast<SeriesPlot*>(data);
+    size_t point = plot->decimator->getIndex(static_cast<size_t>(index));
+    return ImPlotPoint {
+        static_cast<double>(plot->series->getTimestamp(point)) / 1000.0,
+        plot->series->getValue(point),
+    };
+}
 
-    return Aws::CloudWatch::CloudWatchClient{provider, config};
+void ImAws::MonitoringPanel::onClose() {
+    mMetricDescribe.cancel();
+    mMetricDataFetch.cancel();
+    mPlanner.clear();
 }
 
-void ImAws::MonitoringPanel::fetchMetricData(const Metric& metric) {
-    mMetricDataFetch.run([this, metric = auto{metric}](auto&& add, auto&& err, std::stop_token stop) {
-        auto client = createCloudWatchClient();
-        auto now = Aws::Utils::DateTime::Now();
-
-        Aws::CloudWatch::Model::MetricStat metricStat;
-        metricStat.SetMetric(metric);
-        metricStat.SetPeriod(300);
-        metricStat.SetStat("Average");
-
-        Aws::CloudWatch::Model::MetricDataQuery query;
-        query.SetId("metric");
-        query.SetMetricStat(metricStat);
-
-        Aws::CloudWatch::Model::GetMetricDataRequest request;
-        request.SetStartTime(now.Millis() - (3600 * 1000 * 24 * 3)); // 3 days ago
-        request.SetEndTime(now);
-        request.AddMetricDataQueries(query);
-        request.SetMaxDatapoints(500);
-
-        Aws::String nextToken;
-        do {
-            if (!nextToken.empty()) {
-                request.SetNextToken(nextToken);
-            }
+void ImAws::MonitoringPanel::addToGraph(const Metric& metric) {
+    sm::TimeSeriesStore& store = getSession()->getTimeSeries();
+    sm::SeriesId id = store.getOrCreate(GetSeriesKey(metric));
+
+    mMetricName = metric.GetMetricName();
 
-            auto outcome = client.GetMetricData(request);
+    bool isGraphed = std::any_of(mGraph.begin(), mGraph.end(), [&](const GraphSeries& series) {
+        return series.id == id;
+    });
+
+    if (!isGraphed) {
+        std::string label = metric.GetDimensions().empty()
+            ? metric.GetMetricName()
+            : std::format("{} {}", metric.GetMetricName(), GetDimensionsLabel(metric));
+        mGraph.push_back(GraphSeries{id, std::move(label), {}});
+    }
+
+    //
+    // Points already fetched by any window are shown straight away, and
+    // only the periods from the last of them onwards are requested again.
+    //
+    const sm::TimeSeries& series = store.get(id);
+    mAutoFit |= !series.empty();
+
+    int64_t start = Aws::Utils::DateTime::Now().Millis() - kHistoryMillis;
+    if (!series.empty()) {
+        start = std::max(start, series.getTimestamp(series.size() - 1));
+    }
+
+    Aws::CloudWatch::Model::MetricStat metricStat;
+    metricStat.SetMetric(metric);
+    metricStat.SetPeriod(kPeriod);
+    metricStat.SetStat(kStat);
+
+    mPlanner.add(id, std::move(metricStat), start);
+}
+
+void ImAws::MonitoringPanel::fetchNextBatch() {
+    auto request = mPlanner.next(Aws::Utils::DateTime::Now());
+    if (!request.has_value()) {
+        return;
+    }
+
+    mMetricDataFetch.crawl(
+        [context = getClientContext(), request = std::move(*request)](std::stop_token stop) {
+            return sm::paginate<sm::GetMetricDataPages>(context, request, stop);
+        },
+        [](auto& outcome, auto&& add, auto&& err) {
             if (!outcome.IsSuccess()) {
                 err(outcome.GetError());
-                break;
+                return;
             }
 
-            const auto& result = outcome.GetResult();
-            add(result);
-
-            nextToken = result.GetNextToken();
-        } while (!nextToken.empty() && !stop.stop_requested());
-    });
+            add(outcome.GetResultWithOwnership());
+        }
+    );
 }
 
-void ImAws::MonitoringPanel::drawMetricNode(MetricSetIterator it) {
-    const auto& metric = *it;
+void ImAws::MonitoringPanel::drawMetricNode(MetricSetIterator first, MetricSetIterator last) {
+    const auto& name = first->GetMetricName();
 
-    auto name = metric.GetMetricName();
-    if (NextTreeNode(name.c_str(), kDefaultFlags)) {
-        for (auto dimension : metric.GetDimensions()) {
-            auto id = dimension.GetName();
-            auto val = dimension.GetValue();
+    ImGui::AlignTextToFramePadding();
+    bool isOpen = NextTreeNode(name.c_str(), kDefaultFlags | ImGuiTreeNodeFlags_AllowOverlap);
 
-            ImGui::AlignTextToFramePadding();
-            if (NextTreeNode(id.c_str(), kDefaultFlags | ImGuiTreeNodeFlags_AllowOverlap)) {
+    size_t count = static_cast<size_t>(std::distance(first, last));
+    if (count > 1) {
+        ImGui::SameLine();
+        ImGui::PushID(name.c_str());
+        if (ImGui::SmallButton(std::format("Graph All ({})", count).c_str())) {
+            for (auto it = first; it != last; ++it) {
+                addToGraph(*it);
+            }
+        }
+        ImGui::PopID();
+    }
 
-                ImGui::TableNextRow();
-                ImGui::TableNextColumn();
+    if (!isOpen) {
+        return;
+    }
 
-                ImGui::TextUnformatted(val.c_str());
-                ImGui::SameLine();
-                if (ImGui::Button("Graph")) {
-                    mMetricName = name;
-                    fetchMetricData(metric);
-                }
+    for (auto it = first; it != last; ++it) {
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
 
-                ImGui::TreePop();
-            }
+        ImGui::PushID(&*it);
+        ImGui::AlignTextToFramePadding();
+        ImGui::TextUnformatted(GetDimensionsLabel(*it).c_str());
+        ImGui::SameLine();
+        if (ImGui::SmallButton("Graph")) {
+            addToGraph(*it);
         }
-        ImGui::TreePop();
+        ImGui::PopID();
     }
+
+    ImGui::TreePop();
 }
 
 void ImAws::MonitoringPanel::drawMetricNamespace(MetricMapIterator it) {
@@ -112,52 +174,116 @@ void ImAws::MonitoringPanel::drawMetricNamespace(MetricMapIterator it) {
     ImGui::TableNextColumn();
 
     if (ImGui::TreeNodeEx(ns.c_str(), kDefaultFlags)) {
-        for (auto metric = metrics.begin(); metric != metrics.end(); ++metric) {
-            drawMetricNode(metric);
+        auto first = metrics.begin();
+        while (first != metrics.end()) {
+            auto last = std::find_if(first, metrics.end(), [&](const Metric& metric) {
+                return metric.GetMetricName() != first->GetMetricName();
+            });
+
+            drawMetricNode(first, last);
+            first = last;
         }
         ImGui::TreePop();
     }
 }
 
+void ImAws::MonitoringPanel::drawGraph() {
+    const sm::TimeSeriesStore& store = getSession()->getTimeSeries();
+
+    if (!ImPlot::BeginPlot("Plot")) {
+        return;
+    }
+
+    ImPlotAxisFlags flags = ImPlotAxisFlags_None; //ImPlotAxisFlags_AutoFit | ImPlotAxisFlags_RangeFit;
+    ImPlot::SetupAxes("Time", mGraph.size() == 1 ? mMetricName.c_str() : "Value", flags, flags);
+    ImPlot::SetupAxisScale(ImAxis_X1, ImPlotScale_Time);
+
+    //
+    // ImPlot fits to the points that are plotted, after decimation those
+    // are only the ones in view. Fit to the whole of every series here
+    // instead so new data outside the current limits is found.
+    //
+    if (mAutoFit) {
+        ImPlotRect bounds{INFINITY, -INFINITY, INFINITY, -INFINITY};
+        for (const GraphSeries& graph : mGraph) {
+            const sm::TimeSeries& series = store.get(graph.id);
+            if (series.empty()) {
+                continue;
+            }
+
+            auto [low, high] = series.getValueBounds(sm::TimeSeriesRange{0, series.size()});
+            bounds.X.Min = std::min(bounds.X.Min, static_cast<double>(series.getTimestamp(0)) / 1000.0);
+            bounds.X.Max = std::max(bounds.X.Max, static_cast<double>(series.getTimestamp(series.size() - 1)) / 1000.0);
+            bounds.Y.Min = std::min(bounds.Y.Min, low);
+            bounds.Y.Max = std::max(bounds.Y.Max, high);
+        }
+
+        if (bounds.X.Min <= bounds.X.Max) {
+            double low = bounds.Y.Min;
+            double high = bounds.Y.Max;
+            double pad = (high > low) ? (high - low) * 0.05 : std::max(std::abs(high) * 0.05, 1.0);
+            ImPlot::SetupAxesLimits(bounds.X.Min, bounds.X.Max, low - pad, high + pad, ImPlotCond_Always);
+            mAutoFit = false;
+        }
+    }
+
+    ImPlotRect limits = ImPlot::GetPlotLimits();
+    int pixels = static_cast<int>(ImPlot::GetPlotSize().x);
+
+    for (GraphSeries& graph : mGraph) {
+        const sm::TimeSeries& series = store.get(graph.id);
+        if (series.empty()) {
+            continue;
+        }
+
+        graph.decimator.update(limits.X.Min, limits.X.Max, pixels, series.size(), series.getVersion(),
+            [&](size_t i) { return static_cast<double>(series.getTimestamp(i)) / 1000.0; },
+            [&](size_t i) { return series.getValue(i); }
+        );
+
+        // Markers only help while every point is drawn.
+        if (!graph.decimator.isDecimated()) {
+            ImPlot::SetNextMarkerStyle(ImPlotMarker_Circle);
+        }
+
+        SeriesPlot plot{&series, &graph.decimator};
+        ImPlot::PlotLineG(graph.label.c_str(), GetSeriesPoint, &plot, static_cast<int>(graph.decimator.size()));
+    }
+
+    ImPlot::EndPlot();
+}
+
 void ImAws::MonitoringPanel::draw() {
     bool isFetching = mMetricDescribe.isWorking();
     ImGui::BeginDisabled(isFetching);
     if (ImGui::Button(isFetching ? "Fetching..." : "Fetch Metrics")) {
         mAwsMetrics.clear();
         mUserMetrics.clear();
-        mMetricDescribe.run([this](auto&& add, auto&& err, std::stop_token stop) {
-            auto cwClient = createCloudWatchClient();
-
-            Aws::CloudWatch::Model::ListMetricsRequest request;
-            Aws::String marker;
-
-            do {
-                if (!marker.empty()) {
-                    request.SetNextToken(marker);
-                }
-
-                auto outcome = cwClient.ListMetrics(request);
+        mMetricDescribe.setCapacity(8);
+        mMetricDescribe.crawl(
+            [context = getClientContext()](std::stop_token stop) {
+                return sm::paginate<sm::ListMetricsPages>(context, {}, stop);
+            },
+            [](auto& outcome, auto&& add, auto&& err) {
                 if (!outcome.IsSuccess()) {
                     err(outcome.GetError());
-                    break;
+                    return;
                 }
 
-                const auto& result = outcome.GetResult();
-                for (const auto& metric : result.GetMetrics()) {
-                    add(metric);
-                }
-
-                marker = result.GetNextToken();
-            } while (!marker.empty() && !stop.stop_requested());
-        });
+                add(outcome.GetResult().GetMetrics());
+            }
+        );
     }
     ImGui::EndDisabled();
 
-    if (auto metric = mMetricDescribe.pullItem()) {
-        if (metric->GetNamespace().starts_with("AWS/")) {
-            mAwsMetrics[metric->GetNamespace()].insert(*metric);
-        } else {
-            mUserMetrics[metric->GetNamespace()].insert(*metric);
+    //
+    // Each page is a whole ListMetrics response, the stream capacity bounds
+    // how many of them can be waiting here so draining everything is cheap.
+    //
+    while (auto page = mMetricDescribe.pullPage()) {
+        for (auto& metric : *page) {
+            auto& metrics = metric.GetNamespace().starts_with("AWS/") ? mAwsMetrics : mUserMetrics;
+            metrics[metric.GetNamespace()].insert(std::move(metric));
         }
     }
 
@@ -171,54 +297,73 @@ void ImAws::MonitoringPanel::draw() {
         mMetricDataFetch.clear();
     }
 
+    sm::TimeSeriesStore& store = getSession()->getTimeSeries();
+
+    size_t points = 0;
+    for (const GraphSeries& graph : mGraph) {
+        points += store.get(graph.id).size();
+    }
+
     ImGui::SameLine();
-    ImGui::Text("Data Points: %zu", mPlotXData.size());
+    ImGui::Text("Series: %zu, Data Points: %zu", mGraph.size(), points);
+
+    if (!mGraph.empty()) {
+        ImGui::SameLine();
+        if (ImGui::Button("Clear Graph")) {
+            mGraph.clear();
+        }
+    }
+
+    if (!mPlanner.empty() || mMetricDataFetch.isWorking()) {
+        ImGui::SameLine();
+        ImGui::Text("Fetching... (%zu queued)", mPlanner.size());
+    }
 
     mErrorPanel.draw();
 
-    if (auto next = mMetricDataFetch.pullItem()) {
-        //
-        // Only auto-fit once on new data arrival, without this the plot
-        // would keep re-fitting everytime a new chunk of data arrives.
-        // I find that behavior incredibly annoying.
-        //
-        if (!mPlotXData.empty()) {
-            mAutoFit = true;
-        }
+    //
+    // Checked before draining so every page of a finished request has
+    // been pulled by the time the next one starts, starting a crawl
+    // drops whatever the previous one left undelivered.
+    //
+    bool isIdle = !mMetricDataFetch.isWorking();
 
+    while (auto next = mMetricDataFetch.pullItem()) {
         for (const auto& result : next->GetMetricDataResults()) {
-            if (result.GetId() == "metric") {
-                for (const auto& timestamp : result.GetTimestamps()) {
-                    mPlotXData.push_back(static_cast<float>(timestamp.Millis() / 1000.0));
-                }
-
-                for (const auto& value : result.GetValues()) {
-                    mPlotYData.push_back(static_cast<float>(value));
-                }
+            auto id = MetricQueryPlanner::parseQueryId(result.GetId());
+            if (!id || *id >= store.size()) {
+                continue;
             }
-        }
-    }
 
-    if (mAutoFit) {
-        ImPlot::SetNextAxisToFit(ImAxis_X1);
-        ImPlot::SetNextAxisToFit(ImAxis_Y1);
-        mAutoFit = false;
-    }
+            sm::TimeSeries& series = store.get(*id);
 
-    if (ImPlot::BeginPlot("Plot")) {
-        ImPlotAxisFlags flags = ImPlotAxisFlags_None; //ImPlotAxisFlags_AutoFit | ImPlotAxisFlags_RangeFit;
-        ImPlot::SetupAxes("Time", mMetricName.c_str(), flags, flags);
+            //
+            // Only auto-fit once on new data arrival, without this the plot
+            // would keep re-fitting everytime a new chunk of data arrives.
+            // I find that behavior incredibly annoying.
+            //
+            if (series.empty()) {
+                mAutoFit = true;
+            }
 
-        if (!mPlotXData.empty() && !mPlotYData.empty()) {
-            ImPlot::SetupAxisScale(ImAxis_X1, ImPlotScale_Time);
-            assert(mPlotXData.size() == mPlotYData.size());
-            ImPlot::SetNextMarkerStyle(ImPlotMarker_Circle);
-            ImPlot::PlotLine(mMetricName.c_str(), mPlotXData.data(), mPlotYData.data(), static_cast<int>(mPlotXData.size()), ImPlotLineFlags_Segments);
+            const auto& timestamps = result.GetTimestamps();
+            const auto& values = result.GetValues();
+            for (size_t i = 0; i < std::min(timestamps.size(), values.size()); ++i) {
+                series.append(timestamps[i].Millis(), values[i]);
+            }
         }
+    }
 
-        ImPlot::EndPlot();
+    //
+    // One request is in flight at a time. Series graphed meanwhile queue up
+    // in the planner and go out together in the next request.
+    //
+    if (isIdle) {
+        fetchNextBatch();
     }
 
+    drawGraph();
+
     if (ImGui::BeginTable("##MetricTable", 1, ImGuiTableFlags_RowBg)) {
         if (!mUserMetrics.empty()) {
             ImGui::TableNextRow();
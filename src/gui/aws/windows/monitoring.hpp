@@ -1,32 +1,50 @@
 #pragma once
 
 #include "gui/aws/errors.hpp"
+#include "gui/aws/metric_query.hpp"
 #include "gui/aws/window.hpp"
+#include "util/decimate.hpp"
 #include "util/stream.hpp"
+#include "util/time_series.hpp"
 
 #include <aws/monitoring/CloudWatchClient.h>
 
-namespace ImAws {
-    struct MetricPlot {
-        std::string metricNamespace;
-        std::string metricName;
-        std::string displayName;
-        std::vector<float> xData;
-        std::vector<float> yData;
-        bool enabled;
-    };
+#include <algorithm>
+#include <tuple>
 
+namespace ImAws {
     class MonitoringPanel final : public IWindow {
         using Metric = Aws::CloudWatch::Model::Metric;
         using GetMetricDataResult = Aws::CloudWatch::Model::GetMetricDataResult;
         using CloudWatchError = Aws::CloudWatch::CloudWatchError;
 
+        //
+        // Orders by name then dimensions, metrics with the same name are
+        // next to each other and each dimension set is kept, one per
+        // instance, queue, function and so on.
+        //
         struct MetricNameCompare {
             bool operator()(const Metric& a, const Metric& b) const {
-                return a.GetMetricName() < b.GetMetricName();
+                if (a.GetMetricName() != b.GetMetricName()) {
+                    return a.GetMetricName() < b.GetMetricName();
+                }
+
+                return std::lexicographical_compare(
+                    a.GetDimensions().begin(), a.GetDimensions().end(),
+                    b.GetDimensions().begin(), b.GetDimensions().end(),
+                    [](const auto& lhs, const auto& rhs) {
+                        return std::tie(lhs.GetName(), lhs.GetValue()) < std::tie(rhs.GetName(), rhs.GetValue());
+                    }
+                );
             }
         };
 
+        struct GraphSeries {
+            sm::SeriesId id; // in the session's time series store
+            std::string label;
+            sm::MinMaxDecimator decimator;
+        };
+
         using MetricSet = std::set<Metric, MetricNameCompare>;
         using MetricMap = std::map<std::string, MetricSet>;
         using MetricSetIterator = MetricSet::iterator;
@@ -40,17 +58,22 @@ namespace ImAws {
 
         sm::AsyncStream<GetMetricDataResult, CloudWatchError> mMetricDataFetch;
 
+        MetricQueryPlanner mPlanner;
+
         bool mAutoFit = false;
         std::string mMetricName = "Metric";
-        std::vector<float> mPlotXData;
-        std::vector<float> mPlotYData;
-
-        Aws::CloudWatch::CloudWatchClient createCloudWatchClient();
+        std::vector<GraphSeries> mGraph;
 
-        void fetchMetricData(const Metric& metric);
+        void addToGraph(const Metric& metric);
+        void fetchNextBatch();
+        void drawGraph();
 
-        void drawMetricNode(MetricSetIterator it);
+        void drawMetricNode(MetricSetIterator first, MetricSetIterator last);
         void drawMetricNamespace(MetricMapIterator it);
+
+    protected:
+        void onClose() override;
+
     public:
         using IWindow::IWindow;
 
@@ -88,71 +88,28 @@ std::string ImAws::AwsRegion::getSelectedRegionId() const {
     return kRegionNames[mIndex];
 }
 
-void ImAws::ArnTooltip(const Aws::String& arn) {
-    ImGui::TextUnformatted(arn.c_str());
+void ImAws::ArnTooltip(std::string_view arn) {
+    ArnTooltip(sm::Arn::parse(sm::InternedString{arn.data(), static_cast<uint32_t>(arn.size())}));
+}
+
+void ImAws::ArnTooltip(const sm::Arn& arn) {
+    sm::InternedString text = arn.getText();
+    ImGui::TextUnformatted(text.data(), text.end());
 
     if (ImGui::BeginItemTooltip()) {
         defer { ImGui::EndTooltip(); };
         ImGui::TextUnformatted("Amazon Resource Name (ARN)");
 
-        size_t arnEndIndex = arn.find(':', 0);
-        if (arnEndIndex == Aws::String::npos) {
-            ImGui::TextUnformatted("Invalid ARN");
-            return;
-        }
-
-        size_t partitionEndIndex = arn.find(':', arnEndIndex + 1);
-        if (partitionEndIndex == Aws::String::npos) {
-            ImGui::TextUnformatted("Invalid ARN");
-            return;
-        }
-
-        size_t serviceEndIndex = arn.find(':', partitionEndIndex + 1);
-        if (serviceEndIndex == Aws::String::npos) {
-            ImGui::TextUnformatted("Invalid ARN");
-            return;
-        }
-
-        size_t regionEndIndex = arn.find(':', serviceEndIndex + 1);
-        if (regionEndIndex == Aws::String::npos) {
+        if (!arn.isValid()) {
             ImGui::TextUnformatted("Invalid ARN");
             return;
         }
 
-        size_t accountIdEndIndex = arn.find(':', regionEndIndex + 1);
-        if (accountIdEndIndex == Aws::String::npos) {
-            ImGui::TextUnformatted("Invalid ARN");
-            return;
-        }
-
-        bool hasResoureType = false;
-
-        size_t resourceTypeEndIndex = arn.find_first_of("/:", accountIdEndIndex + 1);
-        if (resourceTypeEndIndex == Aws::String::npos) {
-            resourceTypeEndIndex = arn.length();
-
-            //
-            // Assume no resource type
-            //
-        } else {
-            //
-            // Resource type present
-            //
-
-            size_t nextCharIndex = resourceTypeEndIndex + 1;
-            if (nextCharIndex >= arn.length()) {
-                ImGui::TextUnformatted("Invalid ARN");
-                return;
-            }
-
-            hasResoureType = true;
-        }
-
-        std::string_view arnView{arn};
-        std::string_view partition = arnView.substr(arnEndIndex + 1, partitionEndIndex - arnEndIndex - 1);
-        std::string_view service = arnView.substr(partitionEndIndex + 1, serviceEndIndex - partitionEndIndex - 1);
-        std::string_view region = arnView.substr(serviceEndIndex + 1, regionEndIndex - serviceEndIndex - 1);
-        std::string_view accountId = arnView.substr(regionEndIndex + 1, accountIdEndIndex - regionEndIndex - 1);
+        std::string_view partition = arn.getPartition();
+        std::string_view service = arn.getService();
+        std::string_view region = arn.getRegion();
+        std::string_view accountId = arn.getAccountId();
+        std::string_view resourceId = arn.getResourceId();
 
         ImGui::BulletText("Partition: %.*s", (int)partition.length(), partition.data());
         ImGui::BulletText("Service: %.*s", (int)service.length(), service.data());
@@ -169,10 +126,12 @@ void ImAws::ArnTooltip(const Aws::String& arn) {
             ImGui::BulletText("Account ID: %.*s", (int)accountId.length(), accountId.data());
         }
 
-        if (hasResoureType) {
-            ImGui::BulletText("Resource Type: %.*s", static_cast<int>(resourceTypeEndIndex - accountIdEndIndex - 1), arn.c_str() + accountIdEndIndex + 1);
+        if (arn.hasResourceType()) {
+            std::string_view resourceType = arn.getResourceType();
+            ImGui::BulletText("Resource Type: %.*s", (int)resourceType.length(), resourceType.data());
         }
-        ImGui::BulletText("Resource ID: %s", arn.c_str() + resourceTypeEndIndex + 1);
+
+        ImGui::BulletText("Resource ID: %.*s", (int)resourceId.length(), resourceId.data());
     }
 }
 
@@ -2,9 +2,12 @@
 
 #include <cstddef>
 #include <string>
+#include <string_view>
 
 #include <imgui.h>
 
+#include "util/arn.hpp"
+
 #include <aws/core/auth/AWSCredentialsProvider.h>
 #include <aws/core/utils/memory/stl/AWSString.h>
 #include <aws/core/client/AWSError.h>
@@ -15,7 +18,8 @@ namespace ImAws {
     class AwsCredentialState;
 
     void RegionCombo(const char *label, AwsRegion *region, ImGuiComboFlags flags = ImGuiComboFlags_None);
-    void ArnTooltip(const Aws::String& arn);
+    void ArnTooltip(std::string_view arn);
+    void ArnTooltip(const sm::Arn& arn);
     void InputCredentials(AwsCredentialState *credentials);
 
     template<typename T>
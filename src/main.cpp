@@ -1,3 +1,4 @@
+#include "gui/aws/live_tail.hpp"
 #include "gui/aws/session.hpp"
 #include "gui/aws/session/create_session_panel.hpp"
 #include "gui/aws/window.hpp"
@@ -5,6 +6,8 @@
 #include "platform/aws.hpp"
 #include "gui/imaws.hpp"
 #include "util/async.hpp"
+#include "util/executor.hpp"
+#include "util/log_db.hpp"
 
 #include <imgui.h>
 #include <implot.h>
@@ -51,6 +54,7 @@ namespace {
     bool gShowPlotDemoWindow = false;
     bool gShowPlot3dDemoWindow = false;
     bool gShowAwsSdkInfoWindow = false;
+    bool gShowExecutorWindow = false;
 }
 
 class CreateSessionWindow {
@@ -202,6 +206,7 @@ void loop() {
             ImGui::MenuItem("ImPlot Demo Window", nullptr, &gShowPlotDemoWindow);
             ImGui::MenuItem("ImPlot3D Demo Window", nullptr, &gShowPlot3dDemoWindow);
             ImGui::MenuItem("AWS SDK Info", nullptr, &gShowAwsSdkInfoWindow);
+            ImGui::MenuItem("Thread Pool", nullptr, &gShowExecutorWindow);
             ImGui::EndMenu();
         }
 
@@ -242,6 +247,7 @@ void loop() {
 
             ImGui::SeparatorText("sqlite3");
             ImGui::Text("Version: %s", sqlite3_libversion());
+            ImGui::Text("FTS5: %s", sm::LogDatabase::get().hasFullTextSearch() ? "Yes" : "No");
 
             ImGui::SeparatorText("ImGui");
             ImGui::Text("ImGui Version: %s", IMGUI_VERSION);
@@ -258,6 +264,20 @@ void loop() {
         }
     }
 
+    if (gShowExecutorWindow) {
+        if (auto _ = ImAws::Begin("Thread Pool", &gShowExecutorWindow)) {
+            auto stats = sm::Executor::get().getStats();
+            float utilisation = static_cast<float>(stats.busyWorkers) / static_cast<float>(stats.workerCount);
+
+            ImGui::Text("Workers: %u", stats.workerCount);
+            ImGui::Text("Busy: %u", stats.busyWorkers);
+            ImGui::ProgressBar(utilisation, ImVec2(-1.0f, 0.0f));
+            ImGui::Text("Queued Tasks: %zu", stats.queuedTasks);
+            ImGui::Text("Completed Tasks: %llu", static_cast<unsigned long long>(stats.completedTasks));
+            ImGui::Text("Stolen Tasks: %llu", static_cast<unsigned long long>(stats.stolenTasks));
+        }
+    }
+
     for (auto& session : gSessions) {
         session->draw();
     }
@@ -299,6 +319,22 @@ int main(int argc, char **argv) {
         sm::Platform::run(loop);
     }
 
+    //
+    // Cancel and join anything still talking to AWS before the SDK goes away.
+    //
+    sm::Executor::get().shutdown();
+
+    //
+    // After the executor, local searches run on its workers.
+    //
+    sm::LogDatabase::get().shutdown();
+
+    //
+    // Live tail sessions run on their own threads, closed windows may
+    // have left some still winding down.
+    //
+    ImAws::LiveTail::shutdown();
+
     Aws::ShutdownAPI(options);
 
     sm::Platform::finalize();
@@ -1,6 +1,8 @@
 #include "emscripten.hpp"
 #include "implot3d.h"
 
+#include "util/log_db.hpp"
+
 #include <emscripten.h>
 
 #include <filesystem>
@@ -94,6 +96,7 @@ namespace {
         }
 
         io.IniFilename = "/storage/imgui.ini";
+        sm::LogDatabase::configure("/storage/imaws-logs.db");
         io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;
         io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
 
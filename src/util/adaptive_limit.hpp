@@ -0,0 +1,49 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+
+namespace sm {
+    //
+    // Additive increase, multiplicative decrease limit on concurrent
+    // requests. Halved whenever a request is throttled, raised by one after
+    // as many successful requests in a row as the current limit.
+    //
+    class AdaptiveLimit {
+        size_t mLimit;
+        size_t mMaximum;
+        size_t mSuccessStreak = 0;
+        size_t mThrottleCount = 0;
+
+    public:
+        AdaptiveLimit(size_t initial, size_t maximum)
+            : mLimit(std::clamp<size_t>(initial, 1, std::max<size_t>(maximum, 1)))
+            , mMaximum(std::max<size_t>(maximum, 1))
+        { }
+
+        void onSuccess() {
+            mSuccessStreak += 1;
+            if (mSuccessStreak >= mLimit) {
+                mSuccessStreak = 0;
+                mLimit = std::min(mLimit + 1, mMaximum);
+            }
+        }
+
+        void onThrottle() {
+            mThrottleCount += 1;
+            mSuccessStreak = 0;
+            mLimit = std::max<size_t>(1, mLimit / 2);
+        }
+
+        size_t getLimit() const { return mLimit; }
+        size_t getThrottleCount() const { return mThrottleCount; }
+
+        /// @brief Delay before retrying a request throttled @p attempts times in a row.
+        static std::chrono::milliseconds getBackoff(int attempts) {
+            constexpr std::chrono::milliseconds kMinBackoff{250};
+            constexpr std::chrono::milliseconds kMaxBackoff{20000};
+            return std::min(kMaxBackoff, kMinBackoff * (1 << std::clamp(attempts, 0, 10)));
+        }
+    };
+}
@@ -0,0 +1,150 @@
+#include "arn.hpp"
+
+#include <bit>
+#include <cstring>
+#include <limits>
+
+#if defined(__SSE2__)
+#   include <emmintrin.h>
+#endif
+
+using sm::Arn;
+
+namespace {
+    //
+    // Bit i of each mask is set when byte i of the block is that separator.
+    //
+    struct BlockMasks {
+        uint32_t colons;
+        uint32_t slashes;
+    };
+
+#if defined(__SSE2__)
+    constexpr size_t kBlockSize = 16;
+
+    BlockMasks scanBlock(const char *ptr) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+        uint32_t colons = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8(':'))));
+        uint32_t slashes = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8('/'))));
+        return BlockMasks{colons, slashes};
+    }
+#else
+    constexpr size_t kBlockSize = 8;
+
+    constexpr uint64_t kLowBits = 0x0101010101010101ull;
+    constexpr uint64_t kHighBits = 0x8080808080808080ull;
+
+    //
+    // SWAR byte compare, sets the high bit of every byte equal to `c`
+    // without the false positives of the usual haszero trick, then packs
+    // those high bits into the low 8 bits of the result.
+    //
+    uint32_t matchBytes(uint64_t word, char c) {
+        uint64_t x = word ^ (kLowBits * static_cast<uint8_t>(c));
+        uint64_t y = ~(((x & ~kHighBits) + ~kHighBits) | x | ~kHighBits);
+        return static_cast<uint32_t>(((y >> 7) * 0x0102040810204080ull) >> 56);
+    }
+
+    BlockMasks scanBlock(const char *ptr) {
+        uint64_t word;
+        std::memcpy(&word, ptr, sizeof(word));
+        return BlockMasks{matchBytes(word, ':'), matchBytes(word, '/')};
+    }
+#endif
+
+    class ArnScanner {
+        size_t mSeparators[5];
+        size_t mFound = 0;
+        size_t mResourceTypeEnd = std::numeric_limits<size_t>::max();
+
+    public:
+        // Returns true once every separator of interest has been seen.
+        bool visit(size_t index, bool isColon) {
+            if (mFound < 5) {
+                if (isColon) {
+                    mSeparators[mFound++] = index;
+                }
+                return false;
+            }
+
+            mResourceTypeEnd = index;
+            return true;
+        }
+
+        bool isComplete() const { return mFound == 5; }
+        size_t getSeparator(size_t i) const { return mSeparators[i]; }
+        size_t getResourceTypeEnd() const { return mResourceTypeEnd; }
+    };
+
+    ArnScanner scanArn(const char *text, size_t length) {
+        ArnScanner scanner;
+
+        size_t i = 0;
+        for (; i + kBlockSize <= length; i += kBlockSize) {
+            BlockMasks masks = scanBlock(text + i);
+            uint32_t combined = masks.colons | masks.slashes;
+            while (combined != 0) {
+                int bit = std::countr_zero(combined);
+                combined &= combined - 1;
+
+                if (scanner.visit(i + bit, (masks.colons >> bit) & 1)) {
+                    return scanner;
+                }
+            }
+        }
+
+        for (; i < length; ++i) {
+            char c = text[i];
+            if ((c == ':' || c == '/') && scanner.visit(i, c == ':')) {
+                break;
+            }
+        }
+
+        return scanner;
+    }
+}
+
+Arn Arn::parse(InternedString text) {
+    Arn arn;
+    parseArns(std::span(&text, 1), std::span(&arn, 1));
+    return arn;
+}
+
+void sm::parseArns(std::span<const InternedString> texts, std::span<Arn> arns) {
+    for (size_t i = 0; i < texts.size(); ++i) {
+        InternedString text = texts[i];
+        Arn& arn = arns[i];
+
+        arn = Arn{};
+        arn.mText = text;
+
+        if (text.size() >= std::numeric_limits<uint16_t>::max()) {
+            continue;
+        }
+
+        ArnScanner scanner = scanArn(text.data(), text.size());
+        if (!scanner.isComplete()) {
+            continue;
+        }
+
+        arn.mPrefixEnd = static_cast<uint16_t>(scanner.getSeparator(0));
+        arn.mPartitionEnd = static_cast<uint16_t>(scanner.getSeparator(1));
+        arn.mServiceEnd = static_cast<uint16_t>(scanner.getSeparator(2));
+        arn.mRegionEnd = static_cast<uint16_t>(scanner.getSeparator(3));
+        arn.mAccountIdEnd = static_cast<uint16_t>(scanner.getSeparator(4));
+
+        size_t resourceTypeEnd = scanner.getResourceTypeEnd();
+        if (resourceTypeEnd == std::numeric_limits<size_t>::max()) {
+            arn.mResourceTypeEnd = arn.mAccountIdEnd;
+        } else if (resourceTypeEnd + 1 >= text.size()) {
+            //
+            // A resource type with nothing after it
+            //
+            continue;
+        } else {
+            arn.mResourceTypeEnd = static_cast<uint16_t>(resourceTypeEnd);
+        }
+
+        arn.mValid = true;
+    }
+}
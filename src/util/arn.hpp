@@ -0,0 +1,73 @@
+#pragma once
+
+#include "util/intern.hpp"
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace sm {
+    //
+    // A parsed Amazon Resource Name. Stores the offsets of each separator
+    // into the original text so the components can be read without scanning
+    // the string again. The text is not owned, it is expected to be interned.
+    //
+    //   arn:partition:service:region:account-id:resource-type/resource-id
+    //   arn:partition:service:region:account-id:resource-type:resource-id
+    //   arn:partition:service:region:account-id:resource-id
+    //
+    class Arn {
+        InternedString mText;
+
+        // Index of the colon terminating each component.
+        uint16_t mPrefixEnd = 0;
+        uint16_t mPartitionEnd = 0;
+        uint16_t mServiceEnd = 0;
+        uint16_t mRegionEnd = 0;
+        uint16_t mAccountIdEnd = 0;
+
+        // Index of the '/' or ':' after the resource type, equal to
+        // mAccountIdEnd when there is no resource type.
+        uint16_t mResourceTypeEnd = 0;
+
+        bool mValid = false;
+
+        std::string_view slice(size_t begin, size_t end) const {
+            if (!mValid) {
+                return {};
+            }
+
+            return mText.view().substr(begin, end - begin);
+        }
+
+        friend void parseArns(std::span<const InternedString> texts, std::span<Arn> arns);
+
+    public:
+        Arn() = default;
+
+        static Arn parse(InternedString text);
+
+        bool isValid() const { return mValid; }
+        bool hasResourceType() const { return mValid && mResourceTypeEnd != mAccountIdEnd; }
+
+        InternedString getText() const { return mText; }
+        const char *c_str() const { return mText.c_str(); }
+
+        std::string_view getPartition() const { return slice(mPrefixEnd + 1, mPartitionEnd); }
+        std::string_view getService() const { return slice(mPartitionEnd + 1, mServiceEnd); }
+        std::string_view getRegion() const { return slice(mServiceEnd + 1, mRegionEnd); }
+        std::string_view getAccountId() const { return slice(mRegionEnd + 1, mAccountIdEnd); }
+
+        std::string_view getResourceType() const {
+            return hasResourceType() ? slice(mAccountIdEnd + 1, mResourceTypeEnd) : std::string_view{};
+        }
+
+        std::string_view getResourceId() const {
+            size_t begin = hasResourceType() ? mResourceTypeEnd + 1 : mAccountIdEnd + 1;
+            return mValid ? mText.view().substr(begin) : std::string_view{};
+        }
+    };
+
+    /// @brief Parse many ARNs at once, @p arns must be at least as long as @p texts.
+    void parseArns(std::span<const InternedString> texts, std::span<Arn> arns);
+}
@@ -1,9 +1,9 @@
 #pragma once
 
+#include "util/executor.hpp"
+
 #include <atomic>
-#include <memory>
 #include <optional>
-#include <thread>
 #include <cassert>
 
 namespace sm {
@@ -16,7 +16,7 @@ namespace sm {
     template<typename T>
     class AsyncAction {
         std::atomic<AsyncActionState> mState;
-        std::unique_ptr<std::jthread> mWorkerThread;
+        TaskHandle mTask;
 
         std::optional<T> mResult;
     public:
@@ -24,6 +24,11 @@ namespace sm {
             : mState(AsyncActionState::eIdle)
         { }
 
+        ~AsyncAction() {
+            mTask.requestStop();
+            mTask.wait();
+        }
+
         bool clear() {
             auto expected = AsyncActionState::eComplete;
             return mState.compare_exchange_strong(expected, AsyncActionState::eIdle);
@@ -31,9 +36,7 @@ namespace sm {
 
         void reset() {
             mResult.reset();
-            if (mWorkerThread) {
-                mWorkerThread->request_stop();
-            }
+            mTask.requestStop();
         }
 
         void run(auto&& func) {
@@ -46,7 +49,7 @@ namespace sm {
             mState.store(AsyncActionState::eRunning);
             mResult.reset();
 
-            mWorkerThread = std::make_unique<std::jthread>([this, func = std::move(func)]() {
+            mTask = Executor::get().submit([this, func = std::move(func)](std::stop_token) {
                 mResult = func();
                 mState.store(AsyncActionState::eComplete);
             });
@@ -0,0 +1,215 @@
+#include "column_table.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+
+using sm::ColumnTable;
+
+namespace {
+    bool parseDigits(std::string_view text, size_t offset, size_t count, int& out) {
+        if (offset + count > text.size()) {
+            return false;
+        }
+
+        auto first = text.data() + offset;
+        auto [ptr, ec] = std::from_chars(first, first + count, out);
+        return ec == std::errc{} && ptr == first + count;
+    }
+
+    // Howard Hinnant's days_from_civil.
+    int64_t daysFromCivil(int64_t y, unsigned m, unsigned d) {
+        y -= m <= 2;
+        int64_t era = (y >= 0 ? y : y - 399) / 400;
+        unsigned yoe = static_cast<unsigned>(y - era * 400);
+        unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+        unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + static_cast<int64_t>(doe) - 719468;
+    }
+
+    double parseNumber(std::string_view text, bool& ok) {
+        double value = 0.0;
+        auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+        ok = ec == std::errc{} && ptr == text.data() + text.size();
+        return value;
+    }
+}
+
+int64_t ColumnTable::parseTimestamp(std::string_view text) {
+    if (text.size() < 19 || text[4] != '-' || text[7] != '-' || (text[10] != ' ' && text[10] != 'T') || text[13] != ':' || text[16] != ':') {
+        return kNoTimestamp;
+    }
+
+    int year, month, day, hour, minute, second;
+    if (!parseDigits(text, 0, 4, year) || !parseDigits(text, 5, 2, month) || !parseDigits(text, 8, 2, day)
+        || !parseDigits(text, 11, 2, hour) || !parseDigits(text, 14, 2, minute) || !parseDigits(text, 17, 2, second)) {
+        return kNoTimestamp;
+    }
+
+    if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60) {
+        return kNoTimestamp;
+    }
+
+    int millis = 0;
+    if (text.size() > 19) {
+        if (text[19] != '.' || text.size() != 23 || !parseDigits(text, 20, 3, millis)) {
+            return kNoTimestamp;
+        }
+    }
+
+    int64_t days = daysFromCivil(year, static_cast<unsigned>(month), static_cast<unsigned>(day));
+    return ((days * 24 + hour) * 60 + minute) * 60'000 + second * 1000 + millis;
+}
+
+void ColumnTable::Column::push(std::string_view value) {
+    bytes.insert(bytes.end(), value.begin(), value.end());
+    offsets.push_back(static_cast<uint32_t>(bytes.size()));
+
+    if (value.empty()) {
+        if (mayBeNumber) {
+            numbers.push_back(std::nan(""));
+        }
+        if (mayBeTimestamp) {
+            timestamps.push_back(kNoTimestamp);
+        }
+        return;
+    }
+
+    hasValue = true;
+
+    if (mayBeNumber) {
+        bool ok;
+        double number = parseNumber(value, ok);
+        if (ok) {
+            numbers.push_back(number);
+        } else {
+            mayBeNumber = false;
+            numbers = std::vector<double>{};
+        }
+    }
+
+    if (mayBeTimestamp) {
+        int64_t timestamp = parseTimestamp(value);
+        if (timestamp != kNoTimestamp) {
+            timestamps.push_back(timestamp);
+        } else {
+            mayBeTimestamp = false;
+            timestamps = std::vector<int64_t>{};
+        }
+    }
+}
+
+void ColumnTable::Column::truncate(size_t rowCount) {
+    offsets.resize(rowCount + 1);
+    bytes.resize(offsets.back());
+
+    if (mayBeNumber) {
+        numbers.resize(rowCount);
+    }
+
+    if (mayBeTimestamp) {
+        timestamps.resize(rowCount);
+    }
+}
+
+size_t ColumnTable::findColumn(std::string_view name) const {
+    auto it = std::find_if(mColumns.begin(), mColumns.end(), [&](const Column& column) {
+        return column.name.view() == name;
+    });
+
+    return static_cast<size_t>(it - mColumns.begin());
+}
+
+size_t ColumnTable::findOrAddColumn(std::string_view name) {
+    size_t index = findColumn(name);
+    if (index != mColumns.size()) {
+        return index;
+    }
+
+    Column& column = mColumns.emplace_back();
+    column.name = mNames->intern(name);
+    for (size_t i = 0; i < mRowCount; ++i) {
+        column.push({});
+    }
+
+    return index;
+}
+
+void ColumnTable::appendRow(std::span<const ColumnCell> cells) {
+    for (const ColumnCell& cell : cells) {
+        findOrAddColumn(cell.field);
+    }
+
+    //
+    // Rows have a handful of fields, a linear scan for each column is
+    // cheaper than building a map per row.
+    //
+    for (Column& column : mColumns) {
+        auto it = std::find_if(cells.begin(), cells.end(), [&](const ColumnCell& cell) {
+            return cell.field == column.name.view();
+        });
+
+        column.push(it != cells.end() ? it->value : std::string_view{});
+    }
+
+    mRowCount += 1;
+}
+
+void ColumnTable::clear() {
+    mNames = std::make_unique<StringPool>();
+    mColumns.clear();
+    mRowCount = 0;
+}
+
+void ColumnTable::truncate(size_t rowCount) {
+    if (rowCount >= mRowCount) {
+        return;
+    }
+
+    for (Column& column : mColumns) {
+        column.truncate(rowCount);
+    }
+
+    mRowCount = rowCount;
+}
+
+sm::ColumnKind ColumnTable::getKind(size_t column) const {
+    const Column& data = mColumns[column];
+    if (!data.hasValue) {
+        return ColumnKind::eText;
+    }
+
+    if (data.mayBeTimestamp) {
+        return ColumnKind::eTimestamp;
+    }
+
+    if (data.mayBeNumber) {
+        return ColumnKind::eNumber;
+    }
+
+    return ColumnKind::eText;
+}
+
+bool ColumnTable::less(size_t column, uint32_t lhs, uint32_t rhs) const {
+    switch (getKind(column)) {
+    case ColumnKind::eNumber: {
+        double a = mColumns[column].numbers[lhs];
+        double b = mColumns[column].numbers[rhs];
+        if (std::isnan(a) || std::isnan(b)) {
+            return !std::isnan(a) && std::isnan(b);
+        }
+        return a < b;
+    }
+    case ColumnKind::eTimestamp: {
+        int64_t a = mColumns[column].timestamps[lhs];
+        int64_t b = mColumns[column].timestamps[rhs];
+        if (a == kNoTimestamp || b == kNoTimestamp) {
+            return a != kNoTimestamp && b == kNoTimestamp;
+        }
+        return a < b;
+    }
+    case ColumnKind::eText:
+    default:
+        return getText(column, lhs) < getText(column, rhs);
+    }
+}
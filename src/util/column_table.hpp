@@ -0,0 +1,99 @@
+#pragma once
+
+#include "util/intern.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace sm {
+    enum class ColumnKind {
+        eText,
+        eNumber,
+        eTimestamp,
+    };
+
+    struct ColumnCell {
+        std::string_view field;
+        std::string_view value;
+    };
+
+    //
+    // Table of string valued records stored column by column, such as the
+    // rows of a Logs Insights query. Every cell keeps its text in the
+    // column's packed byte buffer. While every non empty value of a column
+    // parses as a number or a timestamp it also keeps a typed array, which
+    // can be sorted and plotted without touching the text.
+    //
+    // Rows are append only, a column first seen part way through is
+    // backfilled with empty cells.
+    //
+    class ColumnTable {
+        struct Column {
+            InternedString name;
+
+            std::vector<char> bytes;
+            std::vector<uint32_t> offsets{0};
+
+            // Cleared by the first value that does not parse, the typed
+            // array is released at the same time.
+            bool mayBeNumber = true;
+            bool mayBeTimestamp = true;
+            bool hasValue = false;
+            std::vector<double> numbers;
+            std::vector<int64_t> timestamps;
+
+            void push(std::string_view value);
+            void truncate(size_t rowCount);
+        };
+
+        std::unique_ptr<StringPool> mNames = std::make_unique<StringPool>();
+        std::vector<Column> mColumns;
+        size_t mRowCount = 0;
+
+        size_t findOrAddColumn(std::string_view name);
+
+    public:
+        static constexpr int64_t kNoTimestamp = std::numeric_limits<int64_t>::min();
+
+        /// @brief Parse "YYYY-MM-DD HH:MM:SS[.mmm]" as UTC.
+        /// @return Unix epoch milliseconds, or kNoTimestamp.
+        static int64_t parseTimestamp(std::string_view text);
+
+        /// @brief Append one row, fields absent from @p cells are left empty.
+        void appendRow(std::span<const ColumnCell> cells);
+
+        void clear();
+
+        /// @brief Drop every row from @p rowCount on. Columns and their types
+        ///        are kept as they were.
+        void truncate(size_t rowCount);
+
+        size_t getRowCount() const { return mRowCount; }
+        size_t getColumnCount() const { return mColumns.size(); }
+
+        /// @return The index of the column named @p name, or getColumnCount().
+        size_t findColumn(std::string_view name) const;
+
+        InternedString getName(size_t column) const { return mColumns[column].name; }
+        ColumnKind getKind(size_t column) const;
+
+        std::string_view getText(size_t column, size_t row) const {
+            const Column& data = mColumns[column];
+            return std::string_view{data.bytes.data() + data.offsets[row], data.offsets[row + 1] - data.offsets[row]};
+        }
+
+        /// @brief Values of a number column, NaN where the cell is empty.
+        std::span<const double> getNumbers(size_t column) const { return mColumns[column].numbers; }
+
+        /// @brief Values of a timestamp column, kNoTimestamp where the cell is empty.
+        std::span<const int64_t> getTimestamps(size_t column) const { return mColumns[column].timestamps; }
+
+        /// @brief Order @p lhs before @p rhs by the typed value of @p column,
+        ///        empty cells sort last.
+        bool less(size_t column, uint32_t lhs, uint32_t rhs) const;
+    };
+}
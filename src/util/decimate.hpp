@@ -0,0 +1,139 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace sm {
+    //
+    // Reduces a series sorted by x to what a plot of a given width can
+    // show. The x range in view is split into one bucket per pixel and each
+    // bucket keeps only its lowest and highest points, in x order, so spikes
+    // survive however far the plot is zoomed out. The nearest point on
+    // either side of the range is kept too, so lines run off the edges.
+    //
+    // The output is the indices of the points to draw, read back from the
+    // series in place. It is cached and only rebuilt when the axis limits,
+    // the plot width or the data version change. Drawing then costs about
+    // two points per pixel however much data there is.
+    //
+    class MinMaxDecimator {
+        struct Key {
+            double min;
+            double max;
+            int pixels;
+            size_t count;
+            uint64_t version;
+
+            bool operator==(const Key&) const = default;
+        };
+
+        Key mKey{};
+        bool mIsValid = false;
+        bool mIsDecimated = false;
+        size_t mBegin = 0;
+        size_t mEnd = 0;
+        std::vector<size_t> mIndices; // only filled when decimated
+
+    public:
+        /// @brief Rebuild the output for x limits [@p min, @p max] if anything changed.
+        /// @param version Changes whenever points already counted by @p count change.
+        /// @param getX Returns the x of point i, ascending.
+        /// @return True if the output was rebuilt.
+        template<typename GetX, typename GetY>
+        bool update(double min, double max, int pixels, size_t count, uint64_t version, GetX&& getX, GetY&& getY) {
+            Key key{min, max, std::max(pixels, 1), count, version};
+            if (mIsValid && key == mKey) {
+                return false;
+            }
+
+            mKey = key;
+            mIsValid = true;
+            mIndices.clear();
+
+            auto lowerBound = [&](double x) {
+                size_t lo = 0;
+                size_t hi = count;
+                while (lo < hi) {
+                    size_t mid = lo + (hi - lo) / 2;
+                    if (getX(mid) < x) {
+                        lo = mid + 1;
+                    } else {
+                        hi = mid;
+                    }
+                }
+                return lo;
+            };
+
+            size_t begin = lowerBound(min);
+            size_t end = lowerBound(std::nextafter(max, INFINITY));
+            if (begin > 0) {
+                begin -= 1;
+            }
+            if (end < count) {
+                end += 1;
+            }
+
+            mBegin = begin;
+            mEnd = end;
+            mIsDecimated = end - begin > static_cast<size_t>(key.pixels) * 2;
+            if (!mIsDecimated) {
+                return true;
+            }
+
+            double width = (max - min) / key.pixels;
+            size_t lowest = begin;
+            size_t highest = begin;
+            int64_t bucket = INT64_MIN;
+
+            auto flush = [&] {
+                if (bucket == INT64_MIN) {
+                    return;
+                }
+
+                mIndices.push_back(std::min(lowest, highest));
+                if (lowest != highest) {
+                    mIndices.push_back(std::max(lowest, highest));
+                }
+            };
+
+            for (size_t i = begin; i < end; ++i) {
+                double x = getX(i);
+                double y = getY(i);
+
+                // Points outside the limits each get a bucket of their own.
+                int64_t next = (x < min) ? -1 : (x > max) ? key.pixels + 1 : static_cast<int64_t>((x - min) / width);
+
+                if (next != bucket) {
+                    flush();
+                    bucket = next;
+                    lowest = i;
+                    highest = i;
+                    continue;
+                }
+
+                if (y < getY(lowest)) {
+                    lowest = i;
+                }
+                if (y > getY(highest)) {
+                    highest = i;
+                }
+            }
+
+            flush();
+            return true;
+        }
+
+        void invalidate() { mIsValid = false; }
+
+        /// @brief True if points were dropped, false if every point in range was kept.
+        bool isDecimated() const { return mIsDecimated; }
+
+        /// @brief Number of points to draw.
+        size_t size() const { return mIsDecimated ? mIndices.size() : mEnd - mBegin; }
+
+        /// @brief Index into the series of the @p i th point to draw.
+        size_t getIndex(size_t i) const { return mIsDecimated ? mIndices[i] : mBegin + i; }
+    };
+}
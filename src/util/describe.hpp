@@ -1,10 +1,16 @@
 #pragma once
 
-#include <thread>
+#include "util/executor.hpp"
+
 #include <vector>
 #include <atomic>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <span>
+#include <type_traits>
 #include <concurrentqueue.h>
 
 namespace sm {
@@ -13,6 +19,15 @@ namespace sm {
         eFetching,
     };
 
+    //
+    // Limits how much work the UI thread spends moving items out of the
+    // worker queue each frame. Whichever limit is hit first ends the drain.
+    //
+    struct DrainBudget {
+        size_t maxItems = std::numeric_limits<size_t>::max();
+        std::chrono::microseconds maxTime{2000};
+    };
+
     template<typename T, typename E>
     class AsyncDescribe {
         struct Entry {
@@ -20,90 +35,202 @@ namespace sm {
             T item;
         };
 
-        std::atomic<AsyncDescribeState> mState;
-        uint32_t mGeneration;
+        //
+        // Everything a worker touches lives here rather than in the
+        // AsyncDescribe itself. Workers keep the state alive, so a restarted
+        // or destroyed describe never has to wait for them to finish.
+        //
+        struct State {
+            std::atomic<uint32_t> generation{0};
+            std::atomic<uint32_t> completed{0};
+            moodycamel::ConcurrentQueue<Entry> queue;
+
+            std::mutex errorMutex;
+            std::optional<E> error;
+            std::atomic<bool> hasError{false};
+
+            bool isCurrent(uint32_t gen) const {
+                return generation.load() == gen;
+            }
 
-        std::vector<T> mItems;
-        std::unique_ptr<std::jthread> mWorkerThread;
-        moodycamel::ConcurrentQueue<Entry> mItemQueue;
+            void complete(uint32_t gen) {
+                uint32_t prev = completed.load();
+                while (prev < gen && !completed.compare_exchange_weak(prev, gen)) { }
+            }
+
+            void fail(uint32_t gen, E err) {
+                if (!isCurrent(gen)) {
+                    return;
+                }
 
-        std::atomic<bool> mHasError{false};
-        std::optional<E> mLastError;
+                std::lock_guard lock(errorMutex);
+                error = std::move(err);
+                hasError.store(true);
+            }
+        };
+
+        static constexpr size_t kDrainBatchSize = 256;
+
+        std::shared_ptr<State> mShared;
+
+        std::vector<T> mItems;
+        TaskHandle mTask;
+        std::vector<Entry> mDrainBuffer;
 
         void reset() {
             mItems.clear();
-            mHasError.store(false);
-            mLastError.reset();
-            if (mWorkerThread) {
-                mWorkerThread->request_stop();
-            }
+            clear();
+            mTask.requestStop();
         }
 
-        void pullItem() {
-            Entry entry;
-            if (mItemQueue.try_dequeue(entry)) {
-                if (entry.generation == mGeneration) {
-                    mItems.push_back(entry.item);
+        size_t pullItems(size_t limit) {
+            uint32_t generation = mShared->generation.load();
+            size_t count = mShared->queue.try_dequeue_bulk(mDrainBuffer.begin(), std::min(limit, mDrainBuffer.size()));
+            for (size_t i = 0; i < count; ++i) {
+                Entry& entry = mDrainBuffer[i];
+                if (entry.generation == generation) {
+                    mItems.push_back(std::move(entry.item));
                 }
             }
+
+            return count;
         }
 
     public:
         AsyncDescribe()
-            : mState(AsyncDescribeState::eIdle)
-            , mGeneration(0)
+            : mShared(std::make_shared<State>())
+            , mDrainBuffer(kDrainBatchSize)
         { }
 
+        ~AsyncDescribe() {
+            cancel();
+        }
+
         bool isWorking() const {
-            return mState.load() == AsyncDescribeState::eFetching;
+            return mShared->completed.load() != mShared->generation.load();
         }
 
         bool hasError() const {
-            return mHasError.load();
+            return mShared->hasError.load();
         }
 
         E error() const {
             assert(hasError());
-            return mLastError.value();
+            std::lock_guard lock(mShared->errorMutex);
+            return mShared->error.value();
         }
 
-        std::span<const T> getItems() {
-            pullItem();
-            return mItems;
+        /// @brief Move queued items into the item list until the queue is empty
+        ///        or the budget is exhausted.
+        /// @return The number of entries dequeued, including stale ones.
+        size_t drain(DrainBudget budget) {
+            auto start = std::chrono::steady_clock::now();
+            size_t total = 0;
+
+            while (total < budget.maxItems) {
+                size_t count = pullItems(budget.maxItems - total);
+                total += count;
+
+                if (count == 0 || std::chrono::steady_clock::now() - start >= budget.maxTime) {
+                    break;
+                }
+            }
+
+            return total;
         }
 
-        void fail(E error) {
-            mLastError = std::move(error);
-            mHasError.store(true);
+        /// @brief An estimate of how many items are still waiting to be drained.
+        size_t getPendingCount() const {
+            return mShared->queue.size_approx();
+        }
+
+        std::span<const T> getItems(DrainBudget budget = {}) {
+            drain(budget);
+            return mItems;
         }
 
         void clear() {
-            mHasError.store(false);
-            mLastError.reset();
+            std::lock_guard lock(mShared->errorMutex);
+            mShared->hasError.store(false);
+            mShared->error.reset();
+        }
+
+        /// @brief Stop the current worker without waiting for it. Items it
+        ///        already produced are kept, anything after this is dropped.
+        void cancel() {
+            mTask.requestStop();
+            mShared->complete(mShared->generation.fetch_add(1) + 1);
         }
 
         template<typename F>
         void run(F&& fn) {
             reset();
 
-            mWorkerThread.reset(new std::jthread([this, fn = std::forward<F>(fn)](std::stop_token stop) {
-                mState = AsyncDescribeState::eFetching;
-
-                auto generation = ++mGeneration;
+            //
+            // The previous worker is left to wind down on its own, bumping
+            // the generation is enough to have its output discarded.
+            //
+            auto generation = mShared->generation.fetch_add(1) + 1;
 
-                auto add = [this, generation](T item) {
-                    mItemQueue.enqueue({generation, std::move(item)});
+            mTask = Executor::get().submit([shared = mShared, generation, fn = std::forward<F>(fn)](std::stop_token stop) {
+                auto add = [&shared, generation](T item) {
+                    shared->queue.enqueue({generation, std::move(item)});
                 };
 
-                auto err = [this](E error) {
-                    fail(std::move(error));
+                auto err = [&shared, generation](E error) {
+                    shared->fail(generation, std::move(error));
                 };
 
                 fn(add, err, stop);
 
-                mState = AsyncDescribeState::eIdle;
-            }));
+                shared->complete(generation);
+            });
+        }
+
+        /// @brief Fetch a paginated resource one page per executor task.
+        /// @param makePages Called on a worker with the stop token, returns a
+        ///        Generator that yields one page per resumption.
+        /// @param onPage Called with (page, add, err) for every page.
+        template<typename G, typename F>
+        void crawl(G&& makePages, F&& onPage) {
+            using Pages = std::invoke_result_t<std::decay_t<G>&, std::stop_token>;
+
+            struct Crawl {
+                std::shared_ptr<State> shared;
+                uint32_t generation;
+                std::decay_t<G> makePages;
+                std::decay_t<F> onPage;
+                std::optional<Pages> pages;
+
+                bool operator()(std::stop_token stop) {
+                    if (!pages.has_value()) {
+                        pages.emplace(makePages(stop));
+                    }
+
+                    if (!shared->isCurrent(generation) || !pages->next()) {
+                        shared->complete(generation);
+                        return false;
+                    }
+
+                    auto add = [this](T item) {
+                        shared->queue.enqueue({generation, std::move(item)});
+                    };
+
+                    auto err = [this](E error) {
+                        shared->fail(generation, std::move(error));
+                    };
+
+                    onPage(pages->value(), add, err);
+                    return true;
+                }
+            };
+
+            reset();
+
+            auto generation = mShared->generation.fetch_add(1) + 1;
+
+            mTask = Executor::get().submitSteps(Crawl{mShared, generation, std::forward<G>(makePages), std::forward<F>(onPage), std::nullopt});
         }
     };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,233 @@
+#include "executor.hpp"
+
+#include <algorithm>
+
+using sm::Executor;
+
+namespace {
+    std::atomic<unsigned> gConfiguredWorkerCount{0};
+
+    thread_local Executor *tlsExecutor = nullptr;
+    thread_local size_t tlsWorkerIndex = 0;
+
+    unsigned defaultWorkerCount() {
+        //
+        // Most tasks spend their time blocked on HTTP requests rather than
+        // on the CPU, so oversubscribe the cores a little.
+        //
+        unsigned cores = std::max(std::thread::hardware_concurrency(), 1u);
+        return std::max(cores * 2, 4u);
+    }
+}
+
+Executor::Executor(unsigned workerCount) {
+    workerCount = std::max(workerCount, 1u);
+
+    mWorkers.reserve(workerCount);
+    for (unsigned i = 0; i < workerCount; ++i) {
+        mWorkers.push_back(std::make_unique<Worker>());
+    }
+
+    mThreads.reserve(workerCount);
+    for (unsigned i = 0; i < workerCount; ++i) {
+        mThreads.emplace_back([this, i](std::stop_token stop) {
+            workerMain(i, stop);
+        });
+    }
+}
+
+Executor::~Executor() {
+    shutdown();
+}
+
+void Executor::configure(unsigned workerCount) {
+    gConfiguredWorkerCount.store(workerCount);
+}
+
+Executor& Executor::get() {
+    static Executor executor{gConfiguredWorkerCount.load() ? gConfiguredWorkerCount.load() : defaultWorkerCount()};
+    return executor;
+}
+
+sm::TaskHandle Executor::submit(TaskFn fn) {
+    return submit(std::stop_source{}, std::move(fn));
+}
+
+sm::TaskHandle Executor::submit(std::stop_source stop, TaskFn fn) {
+    auto state = std::make_shared<detail::TaskState>();
+    state->stop = std::move(stop);
+
+    if (mShutdown.load()) {
+        state->complete();
+        return state;
+    }
+
+    push(Task{std::move(fn), state}, false);
+    return state;
+}
+
+void Executor::yield(std::stop_source stop, TaskFn fn) {
+    auto state = std::make_shared<detail::TaskState>();
+    state->stop = std::move(stop);
+
+    if (mShutdown.load()) {
+        state->complete();
+        return;
+    }
+
+    push(Task{std::move(fn), state}, true);
+}
+
+void Executor::push(Task task, bool yield) {
+    size_t index = (tlsExecutor == this)
+        ? tlsWorkerIndex
+        : mNextWorker.fetch_add(1) % mWorkers.size();
+
+    Worker& worker = *mWorkers[index];
+    {
+        std::lock_guard lock(worker.mutex);
+        //
+        // Continuations go to the cold end of the deque so everything
+        // else queued on this worker gets a turn first.
+        //
+        if (yield) {
+            worker.tasks.push_front(std::move(task));
+        } else {
+            worker.tasks.push_back(std::move(task));
+        }
+    }
+
+    mQueuedTasks.fetch_add(1);
+
+    //
+    // Take the sleep lock so a worker that has just checked the queue count
+    // cannot miss this notification.
+    //
+    {
+        std::lock_guard lock(mSleepMutex);
+    }
+    mWake.notify_one();
+}
+
+bool Executor::popLocal(size_t index, Task& task) {
+    Worker& worker = *mWorkers[index];
+    std::lock_guard lock(worker.mutex);
+    if (worker.tasks.empty()) {
+        return false;
+    }
+
+    task = std::move(worker.tasks.back());
+    worker.tasks.pop_back();
+    mQueuedTasks.fetch_sub(1);
+    return true;
+}
+
+bool Executor::steal(size_t index, Task& task) {
+    size_t count = mWorkers.size();
+    for (size_t offset = 1; offset < count; ++offset) {
+        Worker& victim = *mWorkers[(index + offset) % count];
+        std::lock_guard lock(victim.mutex);
+        if (victim.tasks.empty()) {
+            continue;
+        }
+
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        mQueuedTasks.fetch_sub(1);
+        mStolenTasks.fetch_add(1);
+        return true;
+    }
+
+    return false;
+}
+
+void Executor::execute(size_t index, Task& task) {
+    Worker& worker = *mWorkers[index];
+    std::stop_token stop = task.state->stop.get_token();
+
+    if (!stop.stop_requested()) {
+        {
+            std::lock_guard lock(worker.mutex);
+            worker.running = task.state;
+        }
+
+        mBusyWorkers.fetch_add(1);
+        task.fn(stop);
+        mBusyWorkers.fetch_sub(1);
+
+        {
+            std::lock_guard lock(worker.mutex);
+            worker.running.reset();
+        }
+    }
+
+    //
+    // Release the callable before signalling completion so anything it
+    // captured is destroyed by the time a waiter wakes up.
+    //
+    task.fn = nullptr;
+    task.state->complete();
+    mCompletedTasks.fetch_add(1);
+}
+
+void Executor::workerMain(size_t index, std::stop_token stop) {
+    tlsExecutor = this;
+    tlsWorkerIndex = index;
+
+    while (!stop.stop_requested()) {
+        Task task;
+        if (popLocal(index, task) || steal(index, task)) {
+            execute(index, task);
+            continue;
+        }
+
+        std::unique_lock lock(mSleepMutex);
+        mWake.wait(lock, stop, [this] { return mQueuedTasks.load() > 0; });
+    }
+}
+
+void Executor::shutdown() {
+    if (mShutdown.exchange(true)) {
+        return;
+    }
+
+    for (auto& worker : mWorkers) {
+        std::lock_guard lock(worker->mutex);
+        for (Task& task : worker->tasks) {
+            task.state->stop.request_stop();
+        }
+
+        if (worker->running) {
+            worker->running->stop.request_stop();
+        }
+    }
+
+    for (auto& thread : mThreads) {
+        thread.request_stop();
+    }
+
+    mThreads.clear();
+
+    //
+    // Anything still queued never ran, release whoever is waiting on it.
+    //
+    for (auto& worker : mWorkers) {
+        std::lock_guard lock(worker->mutex);
+        for (Task& task : worker->tasks) {
+            task.state->complete();
+        }
+        worker->tasks.clear();
+    }
+
+    mQueuedTasks.store(0);
+}
+
+sm::ExecutorStats Executor::getStats() const {
+    return ExecutorStats {
+        .workerCount = static_cast<unsigned>(mWorkers.size()),
+        .busyWorkers = mBusyWorkers.load(),
+        .queuedTasks = mQueuedTasks.load(),
+        .completedTasks = mCompletedTasks.load(),
+        .stolenTasks = mStolenTasks.load(),
+    };
+}
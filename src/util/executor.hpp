@@ -0,0 +1,169 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+namespace sm {
+    namespace detail {
+        struct TaskState {
+            std::stop_source stop;
+            std::atomic<bool> done{false};
+
+            void complete() {
+                done.store(true);
+                done.notify_all();
+            }
+        };
+    }
+
+    /// @brief Refers to a task submitted to an Executor.
+    ///        Dropping the handle does not cancel the task.
+    class TaskHandle {
+        std::shared_ptr<detail::TaskState> mState;
+
+    public:
+        TaskHandle() = default;
+
+        TaskHandle(std::shared_ptr<detail::TaskState> state)
+            : mState(std::move(state))
+        { }
+
+        void requestStop() {
+            if (mState) {
+                mState->stop.request_stop();
+            }
+        }
+
+        bool isDone() const {
+            return !mState || mState->done.load();
+        }
+
+        /// @brief Block until the task has finished running or was discarded.
+        void wait() const {
+            if (mState) {
+                mState->done.wait(false);
+            }
+        }
+
+        std::stop_token getStopToken() const {
+            return mState ? mState->stop.get_token() : std::stop_token{};
+        }
+
+        explicit operator bool() const {
+            return mState != nullptr;
+        }
+    };
+
+    struct ExecutorStats {
+        unsigned workerCount;
+        unsigned busyWorkers;
+        size_t queuedTasks;
+        uint64_t completedTasks;
+        uint64_t stolenTasks;
+    };
+
+    //
+    // Process wide work-stealing thread pool. Each worker owns a deque,
+    // tasks submitted from a worker go to the back of its own deque and are
+    // popped LIFO, idle workers steal from the front of other deques.
+    // Tasks submitted from outside the pool are distributed round robin.
+    //
+    class Executor {
+        using TaskFn = std::function<void(std::stop_token)>;
+
+        template<typename F>
+        struct StepChain {
+            Executor *executor;
+            std::stop_source source;
+            std::shared_ptr<F> step;
+
+            void operator()(std::stop_token stop) const {
+                if ((*step)(stop) && !stop.stop_requested()) {
+                    executor->yield(source, *this);
+                }
+            }
+        };
+
+        struct Task {
+            TaskFn fn;
+            std::shared_ptr<detail::TaskState> state;
+        };
+
+        struct Worker {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+            std::shared_ptr<detail::TaskState> running;
+        };
+
+        std::vector<std::unique_ptr<Worker>> mWorkers;
+        std::vector<std::jthread> mThreads;
+
+        std::mutex mSleepMutex;
+        std::condition_variable_any mWake;
+
+        std::atomic<size_t> mQueuedTasks{0};
+        std::atomic<unsigned> mBusyWorkers{0};
+        std::atomic<uint64_t> mCompletedTasks{0};
+        std::atomic<uint64_t> mStolenTasks{0};
+        std::atomic<size_t> mNextWorker{0};
+        std::atomic<bool> mShutdown{false};
+
+        void push(Task task, bool yield);
+        void yield(std::stop_source stop, TaskFn fn);
+        bool popLocal(size_t index, Task& task);
+        bool steal(size_t index, Task& task);
+        void execute(size_t index, Task& task);
+        void workerMain(size_t index, std::stop_token stop);
+
+    public:
+        explicit Executor(unsigned workerCount);
+        ~Executor();
+
+        Executor(const Executor&) = delete;
+        Executor& operator=(const Executor&) = delete;
+
+        /// @brief Set the worker count used when the shared executor is created.
+        ///        Has no effect once get() has been called.
+        static void configure(unsigned workerCount);
+
+        static Executor& get();
+
+        /// @brief Queue @p fn to run on a worker. The stop token passed to it
+        ///        is signalled by TaskHandle::requestStop or shutdown().
+        TaskHandle submit(TaskFn fn);
+
+        /// @brief Like submit(TaskFn), but the task shares an existing stop source.
+        TaskHandle submit(std::stop_source stop, TaskFn fn);
+
+        /// @brief Run @p step as a chain of tasks, one call per task, until it
+        ///        returns false or the chain is stopped. Other work can run
+        ///        between steps, so a long crawl does not pin a worker.
+        /// @return Handle to the first step, stopping it stops the whole chain.
+        template<typename F>
+        TaskHandle submitSteps(F&& step) {
+            return submitSteps(std::stop_source{}, std::forward<F>(step));
+        }
+
+        /// @brief Like submitSteps(F), but the chain shares an existing stop
+        ///        source, such as that of an earlier chain it continues.
+        template<typename F>
+        TaskHandle submitSteps(std::stop_source stop, F&& step) {
+            using Step = std::decay_t<F>;
+            auto shared = std::make_shared<Step>(std::forward<F>(step));
+            return submit(stop, StepChain<Step>{this, stop, std::move(shared)});
+        }
+
+        /// @brief Cancel all queued and running tasks and join the workers.
+        void shutdown();
+
+        ExecutorStats getStats() const;
+    };
+}
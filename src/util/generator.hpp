@@ -0,0 +1,118 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <optional>
+#include <utility>
+
+namespace sm {
+    //
+    // Minimal synchronous generator, stands in for std::generator which
+    // is not available in every standard library we build against.
+    //
+    template<typename T>
+    class Generator {
+    public:
+        struct promise_type {
+            std::optional<T> value;
+
+            Generator get_return_object() {
+                return Generator{std::coroutine_handle<promise_type>::from_promise(*this)};
+            }
+
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+
+            std::suspend_always yield_value(T item) {
+                value = std::move(item);
+                return {};
+            }
+
+            void return_void() { }
+
+            void unhandled_exception() {
+                std::terminate();
+            }
+        };
+
+        class iterator {
+            Generator *mGenerator;
+
+        public:
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+
+            iterator(Generator *generator = nullptr)
+                : mGenerator(generator)
+            { }
+
+            T& operator*() const { return mGenerator->value(); }
+
+            iterator& operator++() {
+                if (!mGenerator->next()) {
+                    mGenerator = nullptr;
+                }
+                return *this;
+            }
+
+            void operator++(int) { ++*this; }
+
+            bool operator==(std::default_sentinel_t) const {
+                return mGenerator == nullptr;
+            }
+        };
+
+    private:
+        std::coroutine_handle<promise_type> mHandle;
+
+        explicit Generator(std::coroutine_handle<promise_type> handle)
+            : mHandle(handle)
+        { }
+
+    public:
+        Generator(Generator&& other) noexcept
+            : mHandle(std::exchange(other.mHandle, nullptr))
+        { }
+
+        Generator& operator=(Generator&& other) noexcept {
+            if (this != &other) {
+                if (mHandle) {
+                    mHandle.destroy();
+                }
+                mHandle = std::exchange(other.mHandle, nullptr);
+            }
+            return *this;
+        }
+
+        ~Generator() {
+            if (mHandle) {
+                mHandle.destroy();
+            }
+        }
+
+        /// @brief Resume the coroutine until it yields the next value.
+        /// @return False once the coroutine has finished.
+        bool next() {
+            if (!mHandle || mHandle.done()) {
+                return false;
+            }
+
+            mHandle.promise().value.reset();
+            mHandle.resume();
+            return !mHandle.done();
+        }
+
+        T& value() {
+            return *mHandle.promise().value;
+        }
+
+        iterator begin() {
+            return next() ? iterator{this} : iterator{};
+        }
+
+        std::default_sentinel_t end() {
+            return std::default_sentinel;
+        }
+    };
+}
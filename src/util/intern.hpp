@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace sm {
+    /// @brief A string owned by a StringPool. Always null terminated,
+    ///        valid for as long as the pool it came from.
+    class InternedString {
+        const char *mData = "";
+        uint32_t mSize = 0;
+
+    public:
+        InternedString() = default;
+
+        InternedString(const char *data, uint32_t size)
+            : mData(data)
+            , mSize(size)
+        { }
+
+        const char *c_str() const { return mData; }
+        const char *data() const { return mData; }
+        const char *end() const { return mData + mSize; }
+        uint32_t size() const { return mSize; }
+        bool empty() const { return mSize == 0; }
+
+        std::string_view view() const { return {mData, mSize}; }
+        operator std::string_view() const { return view(); }
+
+        bool operator==(const InternedString& other) const {
+            //
+            // Strings from the same pool are deduplicated, comparing
+            // pointers is enough when both came from one pool.
+            //
+            return mData == other.mData || view() == other.view();
+        }
+    };
+
+    //
+    // Append only arena of deduplicated strings. Safe to intern from worker
+    // threads while the UI thread reads previously returned strings, storage
+    // is never moved or freed until the pool itself is destroyed.
+    //
+    class StringPool {
+        static constexpr size_t kChunkSize = 64 * 1024;
+
+        std::mutex mMutex;
+        std::vector<std::unique_ptr<char[]>> mChunks;
+        std::vector<std::unique_ptr<char[]>> mLargeStrings;
+        size_t mChunkUsed = kChunkSize;
+        size_t mBytesUsed = 0;
+        std::unordered_set<std::string_view> mStrings;
+
+        char *allocate(size_t size) {
+            if (size > kChunkSize / 4) {
+                //
+                // Large strings get their own allocation so they don't
+                // waste the tail of the current chunk.
+                //
+                return mLargeStrings.emplace_back(std::make_unique<char[]>(size)).get();
+            }
+
+            if (mChunkUsed + size > kChunkSize) {
+                mChunks.push_back(std::make_unique<char[]>(kChunkSize));
+                mChunkUsed = 0;
+            }
+
+            char *ptr = mChunks.back().get() + mChunkUsed;
+            mChunkUsed += size;
+            return ptr;
+        }
+
+    public:
+        StringPool() = default;
+
+        StringPool(const StringPool&) = delete;
+        StringPool& operator=(const StringPool&) = delete;
+
+        InternedString intern(std::string_view text) {
+            std::lock_guard lock(mMutex);
+
+            if (auto it = mStrings.find(text); it != mStrings.end()) {
+                return InternedString{it->data(), static_cast<uint32_t>(it->size())};
+            }
+
+            char *ptr = allocate(text.size() + 1);
+            std::memcpy(ptr, text.data(), text.size());
+            ptr[text.size()] = '\0';
+
+            mBytesUsed += text.size() + 1;
+            mStrings.emplace(ptr, text.size());
+
+            return InternedString{ptr, static_cast<uint32_t>(text.size())};
+        }
+
+        size_t getBytesUsed() {
+            std::lock_guard lock(mMutex);
+            return mBytesUsed;
+        }
+
+        size_t getStringCount() {
+            std::lock_guard lock(mMutex);
+            return mStrings.size();
+        }
+    };
+}
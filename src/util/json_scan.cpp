@@ -0,0 +1,249 @@
+#include "json_scan.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+using sm::JsonPathSet;
+using sm::JsonKind;
+using sm::JsonSpan;
+
+namespace {
+    class Scanner {
+        std::string_view mText;
+        const JsonPathSet& mPaths;
+        std::span<JsonSpan> mOut;
+        size_t mRemaining;
+
+    public:
+        size_t pos = 0;
+
+        Scanner(std::string_view text, const JsonPathSet& paths, std::span<JsonSpan> out)
+            : mText(text)
+            , mPaths(paths)
+            , mOut(out)
+            , mRemaining(paths.size())
+        { }
+
+        bool isDone() const { return mRemaining == 0; }
+
+        void skipSpace() {
+            while (pos < mText.size() && (mText[pos] == ' ' || mText[pos] == '\t' || mText[pos] == '\n' || mText[pos] == '\r')) {
+                pos += 1;
+            }
+        }
+
+        bool at(char c) const {
+            return pos < mText.size() && mText[pos] == c;
+        }
+
+        // From an opening quote to just past the closing one.
+        bool skipString() {
+            size_t begin = ++pos;
+            while (pos < mText.size()) {
+                auto quote = static_cast<const char*>(std::memchr(mText.data() + pos, '"', mText.size() - pos));
+                if (quote == nullptr) {
+                    return false;
+                }
+
+                size_t end = static_cast<size_t>(quote - mText.data());
+
+                // An odd run of backslashes escapes the quote.
+                size_t slashes = 0;
+                while (end - slashes > begin && mText[end - slashes - 1] == '\\') {
+                    slashes += 1;
+                }
+
+                pos = end + 1;
+                if (slashes % 2 == 0) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool skipContainer() {
+            int depth = 0;
+            while (pos < mText.size()) {
+                switch (mText[pos]) {
+                case '"':
+                    if (!skipString()) {
+                        return false;
+                    }
+                    continue;
+                case '{': case '[':
+                    depth += 1;
+                    break;
+                case '}': case ']':
+                    depth -= 1;
+                    if (depth == 0) {
+                        pos += 1;
+                        return true;
+                    }
+                    break;
+                }
+                pos += 1;
+            }
+            return false;
+        }
+
+        bool skipValue(JsonKind& kind) {
+            if (pos >= mText.size()) {
+                return false;
+            }
+
+            switch (mText[pos]) {
+            case '"':
+                kind = JsonKind::eString;
+                return skipString();
+            case '{':
+                kind = JsonKind::eObject;
+                return skipContainer();
+            case '[':
+                kind = JsonKind::eArray;
+                return skipContainer();
+            case 'n':
+                kind = JsonKind::eNull;
+                break;
+            case 't': case 'f':
+                kind = JsonKind::eBool;
+                break;
+            default:
+                kind = JsonKind::eNumber;
+                break;
+            }
+
+            size_t begin = pos;
+            while (pos < mText.size() && std::string_view{",}] \t\r\n"}.find(mText[pos]) == std::string_view::npos) {
+                pos += 1;
+            }
+            return pos > begin;
+        }
+
+        //
+        // Walk one object. @p candidates are the paths whose first @p depth
+        // keys led here, a value is only descended into when a candidate
+        // continues below it.
+        //
+        bool scanObject(size_t depth, uint64_t candidates) {
+            pos += 1;
+            while (true) {
+                skipSpace();
+                if (at('}')) {
+                    pos += 1;
+                    return true;
+                }
+
+                if (!at('"')) {
+                    return false;
+                }
+
+                size_t keyBegin = pos + 1;
+                if (!skipString()) {
+                    return false;
+                }
+                std::string_view key = mText.substr(keyBegin, pos - 1 - keyBegin);
+
+                skipSpace();
+                if (!at(':')) {
+                    return false;
+                }
+                pos += 1;
+                skipSpace();
+
+                uint64_t matched = 0;
+                uint64_t deeper = 0;
+                for (uint64_t bits = candidates; bits != 0; bits &= bits - 1) {
+                    size_t i = static_cast<size_t>(std::countr_zero(bits));
+                    std::span<const std::string> keys = mPaths.getKeys(i);
+                    if (keys[depth] != key) {
+                        continue;
+                    }
+
+                    if (keys.size() == depth + 1) {
+                        matched |= uint64_t(1) << i;
+                    } else {
+                        deeper |= uint64_t(1) << i;
+                    }
+                }
+
+                size_t valueBegin = pos;
+                JsonKind kind = JsonKind::eObject;
+                if (deeper != 0 && at('{')) {
+                    if (!scanObject(depth + 1, deeper)) {
+                        return false;
+                    }
+
+                    // Every path was found, a path matching this object
+                    // itself would still be counted so it can't be among them.
+                    if (isDone()) {
+                        return true;
+                    }
+                } else if (!skipValue(kind)) {
+                    return false;
+                }
+
+                for (uint64_t bits = matched; bits != 0; bits &= bits - 1) {
+                    JsonSpan& span = mOut[static_cast<size_t>(std::countr_zero(bits))];
+                    if (span.kind != JsonKind::eMissing) {
+                        continue;
+                    }
+
+                    span = (kind == JsonKind::eString)
+                        ? JsonSpan{static_cast<uint32_t>(valueBegin + 1), static_cast<uint32_t>(pos - valueBegin - 2), kind}
+                        : JsonSpan{static_cast<uint32_t>(valueBegin), static_cast<uint32_t>(pos - valueBegin), kind};
+                    mRemaining -= 1;
+                }
+
+                if (isDone()) {
+                    return true;
+                }
+
+                skipSpace();
+                if (at(',')) {
+                    pos += 1;
+                } else if (at('}')) {
+                    pos += 1;
+                    return true;
+                } else {
+                    return false;
+                }
+            }
+        }
+    };
+}
+
+void JsonPathSet::add(std::string_view path) {
+    if (mPaths.size() >= kMaxPaths) {
+        return;
+    }
+
+    std::vector<std::string> keys;
+    size_t begin = 0;
+    while (begin <= path.size()) {
+        size_t end = std::min(path.find('.', begin), path.size());
+        keys.emplace_back(path.substr(begin, end - begin));
+        begin = end + 1;
+    }
+    mPaths.push_back(std::move(keys));
+}
+
+bool sm::scanJson(std::string_view text, const JsonPathSet& paths, std::span<JsonSpan> out) {
+    for (JsonSpan& span : out) {
+        span = JsonSpan{0, 0, JsonKind::eMissing};
+    }
+
+    Scanner scanner{text, paths, out};
+    scanner.skipSpace();
+    if (!scanner.at('{')) {
+        return false;
+    }
+
+    if (paths.empty()) {
+        return true;
+    }
+
+    uint64_t all = paths.size() == 64 ? ~uint64_t(0) : (uint64_t(1) << paths.size()) - 1;
+    scanner.scanObject(0, all);
+    return true;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sm {
+    enum class JsonKind : uint8_t {
+        eMissing,
+        eNull,
+        eBool,
+        eNumber,
+        eString,
+        eObject,
+        eArray,
+    };
+
+    //
+    // Where a value sits in the scanned text. Strings exclude their quotes
+    // and keep escapes as written, objects and arrays include their brackets.
+    //
+    struct JsonSpan {
+        uint32_t offset;
+        uint32_t length;
+        JsonKind kind;
+
+        std::string_view get(std::string_view text) const {
+            return text.substr(offset, length);
+        }
+    };
+
+    //
+    // A set of dotted paths such as "http.status" to pull out of JSON
+    // objects. Keys are compared as written, without unescaping.
+    //
+    class JsonPathSet {
+        std::vector<std::vector<std::string>> mPaths;
+
+    public:
+        static constexpr size_t kMaxPaths = 64;
+
+        /// @brief Add @p path, paths past kMaxPaths are ignored.
+        void add(std::string_view path);
+        void clear() { mPaths.clear(); }
+
+        size_t size() const { return mPaths.size(); }
+        bool empty() const { return mPaths.empty(); }
+        std::span<const std::string> getKeys(size_t i) const { return mPaths[i]; }
+    };
+
+    /// @brief Find every path of @p paths in the JSON object @p text in one
+    ///        pass, without allocating. Values that no path reaches into are
+    ///        skipped over rather than parsed.
+    ///
+    /// @param out One span per path, eMissing where the path is absent.
+    /// @return False if @p text does not start with an object, a malformed
+    ///         tail only leaves later paths missing.
+    bool scanJson(std::string_view text, const JsonPathSet& paths, std::span<JsonSpan> out);
+}
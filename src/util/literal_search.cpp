@@ -0,0 +1,164 @@
+#include "literal_search.hpp"
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#   define SM_LITERAL_SSE2 1
+#   include <immintrin.h>
+#endif
+
+#if SM_LITERAL_SSE2 && (defined(__GNUC__) || defined(__clang__))
+#   define SM_LITERAL_AVX2 1
+#endif
+
+using sm::LiteralSearch;
+
+namespace {
+    using FindFn = size_t(*)(const char *text, size_t size, size_t from, std::string_view needle, bool ignoreCase);
+
+    bool isAsciiAlpha(char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+    }
+
+    char foldCase(char c) {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c | 0x20) : c;
+    }
+
+    // Or'ing 0x20 into a byte folds an upper case letter onto its lower
+    // case form. Only applied where the needle byte is a letter.
+    char getFoldBit(char c, bool ignoreCase) {
+        return ignoreCase && isAsciiAlpha(c) ? 0x20 : 0;
+    }
+
+    bool equalAt(const char *text, std::string_view needle, bool ignoreCase) {
+        if (!ignoreCase) {
+            return std::memcmp(text, needle.data(), needle.size()) == 0;
+        }
+
+        for (size_t i = 0; i < needle.size(); ++i) {
+            if (foldCase(text[i]) != needle[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    size_t findScalar(const char *text, size_t size, size_t from, std::string_view needle, bool ignoreCase) {
+        if (!ignoreCase) {
+            return std::string_view{text, size}.find(needle, from);
+        }
+
+        for (size_t i = from; i + needle.size() <= size; ++i) {
+            if (foldCase(text[i]) == needle.front() && equalAt(text + i, needle, true)) {
+                return i;
+            }
+        }
+        return std::string_view::npos;
+    }
+
+#if SM_LITERAL_SSE2
+    size_t findSse2(const char *text, size_t size, size_t from, std::string_view needle, bool ignoreCase) {
+        const size_t last = needle.size() - 1;
+        const __m128i firstByte = _mm_set1_epi8(needle.front());
+        const __m128i lastByte = _mm_set1_epi8(needle.back());
+        const __m128i firstFold = _mm_set1_epi8(getFoldBit(needle.front(), ignoreCase));
+        const __m128i lastFold = _mm_set1_epi8(getFoldBit(needle.back(), ignoreCase));
+
+        size_t i = from;
+        for (; i + last + 16 <= size; i += 16) {
+            __m128i head = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i)), firstFold);
+            __m128i tail = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i + last)), lastFold);
+            uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(head, firstByte), _mm_cmpeq_epi8(tail, lastByte))));
+
+            while (mask != 0) {
+                size_t at = i + static_cast<size_t>(std::countr_zero(mask));
+                if (equalAt(text + at, needle, ignoreCase)) {
+                    return at;
+                }
+                mask &= mask - 1;
+            }
+        }
+
+        return findScalar(text, size, i, needle, ignoreCase);
+    }
+#endif
+
+#if SM_LITERAL_AVX2
+    __attribute__((target("avx2")))
+    size_t findAvx2(const char *text, size_t size, size_t from, std::string_view needle, bool ignoreCase) {
+        const size_t last = needle.size() - 1;
+        const __m256i firstByte = _mm256_set1_epi8(needle.front());
+        const __m256i lastByte = _mm256_set1_epi8(needle.back());
+        const __m256i firstFold = _mm256_set1_epi8(getFoldBit(needle.front(), ignoreCase));
+        const __m256i lastFold = _mm256_set1_epi8(getFoldBit(needle.back(), ignoreCase));
+
+        size_t i = from;
+        for (; i + last + 32 <= size; i += 32) {
+            __m256i head = _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i)), firstFold);
+            __m256i tail = _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i + last)), lastFold);
+            uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(head, firstByte), _mm256_cmpeq_epi8(tail, lastByte))));
+
+            while (mask != 0) {
+                size_t at = i + static_cast<size_t>(std::countr_zero(mask));
+                if (equalAt(text + at, needle, ignoreCase)) {
+                    return at;
+                }
+                mask &= mask - 1;
+            }
+        }
+
+        return findSse2(text, size, i, needle, ignoreCase);
+    }
+#endif
+
+    struct Implementation {
+        FindFn find;
+        const char *name;
+    };
+
+    const Implementation& getImplementation() {
+        static const Implementation impl = [] {
+#if SM_LITERAL_AVX2
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2")) {
+                return Implementation{findAvx2, "AVX2"};
+            }
+#endif
+#if SM_LITERAL_SSE2
+            return Implementation{findSse2, "SSE2"};
+#else
+            return Implementation{findScalar, "Scalar"};
+#endif
+        }();
+        return impl;
+    }
+}
+
+LiteralSearch::LiteralSearch(std::string_view needle, bool ignoreCase)
+    : mNeedle(needle)
+    , mIgnoreCase(ignoreCase)
+{
+    if (mIgnoreCase) {
+        for (char& c : mNeedle) {
+            c = foldCase(c);
+        }
+    }
+}
+
+size_t LiteralSearch::find(std::string_view text, size_t from) const {
+    if (mNeedle.empty()) {
+        return from <= text.size() ? from : std::string_view::npos;
+    }
+
+    if (from >= text.size() || text.size() - from < mNeedle.size()) {
+        return std::string_view::npos;
+    }
+
+    return getImplementation().find(text.data(), text.size(), from, mNeedle, mIgnoreCase);
+}
+
+const char *LiteralSearch::getImplementationName() {
+    return getImplementation().name;
+}
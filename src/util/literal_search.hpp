@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace sm {
+    //
+    // Finds a fixed string in a block of text. Candidate positions are found
+    // a vector at a time by comparing the first and last bytes of the needle
+    // against two offset loads of the text, only those are compared in full.
+    // On x86 the AVX2 version is chosen at runtime where available, with
+    // SSE2 as the baseline and a scalar version everywhere else.
+    //
+    // Ignoring case only folds ASCII letters.
+    //
+    class LiteralSearch {
+        std::string mNeedle; // folded to lower case when ignoring case
+        bool mIgnoreCase = false;
+
+    public:
+        LiteralSearch() = default;
+        LiteralSearch(std::string_view needle, bool ignoreCase);
+
+        /// @return Offset of the first match at or after @p from, or npos.
+        size_t find(std::string_view text, size_t from = 0) const;
+
+        bool empty() const { return mNeedle.empty(); }
+        size_t size() const { return mNeedle.size(); }
+        std::string_view getNeedle() const { return mNeedle; }
+
+        /// @brief Name of the implementation in use, for diagnostics.
+        static const char *getImplementationName();
+    };
+}
@@ -0,0 +1,495 @@
+#include "log_db.hpp"
+
+#include <sqlite3.h>
+
+#include <algorithm>
+#include <format>
+#include <span>
+#include <vector>
+
+using sm::LogDatabase;
+
+namespace {
+    std::mutex gConfigureMutex;
+    std::string gConfiguredPath = "imaws-logs.db";
+
+    // Bumped whenever the tables change, see LogDatabase::open.
+    constexpr int kSchemaVersion = 2;
+
+    constexpr const char *kDropSchema = R"(
+        DROP TABLE IF EXISTS events_text;
+        DROP TABLE IF EXISTS events;
+        DROP TABLE IF EXISTS log_streams;
+        DROP TABLE IF EXISTS log_groups;
+    )";
+
+    //
+    // Two events of one stream with the same timestamp and message can't
+    // be told apart, across streams they are different events. Timestamp
+    // comes before stream so the key also serves time range searches.
+    //
+    constexpr const char *kSchema = R"(
+        CREATE TABLE IF NOT EXISTS log_groups (
+            id INTEGER PRIMARY KEY,
+            name TEXT NOT NULL UNIQUE
+        );
+
+        CREATE TABLE IF NOT EXISTS log_streams (
+            id INTEGER PRIMARY KEY,
+            group_id INTEGER NOT NULL,
+            name TEXT NOT NULL,
+            UNIQUE (group_id, name)
+        );
+
+        CREATE TABLE IF NOT EXISTS events (
+            id INTEGER PRIMARY KEY,
+            group_id INTEGER NOT NULL,
+            stream_id INTEGER NOT NULL,
+            timestamp INTEGER NOT NULL,
+            hash INTEGER NOT NULL,
+            message TEXT NOT NULL,
+            UNIQUE (group_id, timestamp, stream_id, hash)
+        );
+    )";
+
+    constexpr const char *kFullTextSchema = R"(
+        CREATE VIRTUAL TABLE IF NOT EXISTS events_text USING fts5(
+            message,
+            content = 'events',
+            content_rowid = 'id'
+        );
+    )";
+
+    // CROSS JOIN keeps the index match as the outer loop, otherwise the
+    // planner walks events in timestamp order and probes the index per row.
+    constexpr const char *kFullTextSearch = R"(
+        SELECT events.timestamp, events.message
+        FROM events_text CROSS JOIN events ON events.id = events_text.rowid
+        WHERE events_text MATCH ?1
+            AND events.group_id = (SELECT id FROM log_groups WHERE name = ?2)
+            AND events.timestamp BETWEEN ?3 AND ?4
+        ORDER BY events.timestamp
+        LIMIT ?5
+    )";
+
+    // One "AND instr(...)" per word is appended, binding words from ?6 on.
+    constexpr const char *kScanSearch = R"(
+        SELECT timestamp, message
+        FROM events
+        WHERE group_id = (SELECT id FROM log_groups WHERE name = ?2)
+            AND timestamp BETWEEN ?3 AND ?4
+    )";
+
+    constexpr const char *kScanSearchEnd = R"(
+        ORDER BY timestamp
+        LIMIT ?5
+    )";
+
+    // An empty search skips the full text index, MATCH needs at least one term.
+    constexpr const char *kRangeSearch = R"(
+        SELECT timestamp, message
+        FROM events
+        WHERE group_id = (SELECT id FROM log_groups WHERE name = ?2)
+            AND timestamp BETWEEN ?3 AND ?4
+        ORDER BY timestamp
+        LIMIT ?5
+    )";
+
+    uint64_t hashMessage(std::string_view message) {
+        // FNV-1a
+        uint64_t hash = 14695981039346656037ull;
+        for (char c : message) {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    std::vector<std::string_view> splitWords(std::string_view text) {
+        std::vector<std::string_view> words;
+        size_t i = 0;
+        while (i < text.size()) {
+            size_t begin = text.find_first_not_of(" \t\r\n", i);
+            if (begin == std::string_view::npos) {
+                break;
+            }
+
+            size_t end = std::min(text.find_first_of(" \t\r\n", begin), text.size());
+            words.push_back(text.substr(begin, end - begin));
+            i = end;
+        }
+        return words;
+    }
+
+    //
+    // Quote every word so user input can't be read as FTS5 query syntax,
+    // the terms are then implicitly ANDed.
+    //
+    std::string makeMatchExpression(std::span<const std::string_view> words) {
+        std::string expression;
+        for (std::string_view word : words) {
+            if (!expression.empty()) {
+                expression += ' ';
+            }
+
+            expression += '"';
+            for (char c : word) {
+                if (c == '"') {
+                    expression += '"';
+                }
+                expression += c;
+            }
+            expression += '"';
+        }
+        return expression;
+    }
+
+    //
+    // Without FTS5 every word must still appear, as with MATCH. lower()
+    // folds ASCII only, as the default FTS5 tokenizer does for most text.
+    //
+    std::string makeScanSearch(size_t words) {
+        std::string sql = kScanSearch;
+        for (size_t i = 0; i < words; ++i) {
+            sql += std::format("    AND instr(lower(message), lower(?{})) > 0\n", i + 6);
+        }
+        sql += kScanSearchEnd;
+        return sql;
+    }
+
+    bool exec(sqlite3 *db, const char *sql, std::string& error) {
+        char *message = nullptr;
+        if (sqlite3_exec(db, sql, nullptr, nullptr, &message) != SQLITE_OK) {
+            error = message ? message : sqlite3_errmsg(db);
+            sqlite3_free(message);
+            return false;
+        }
+        return true;
+    }
+
+    bool prepare(sqlite3 *db, const char *sql, sqlite3_stmt **stmt, std::string& error) {
+        if (sqlite3_prepare_v3(db, sql, -1, SQLITE_PREPARE_PERSISTENT, stmt, nullptr) != SQLITE_OK) {
+            error = sqlite3_errmsg(db);
+            return false;
+        }
+        return true;
+    }
+}
+
+LogDatabase::LogDatabase(const std::string& path) {
+    if (!open(path)) {
+        sqlite3_close(mWriter);
+        sqlite3_close(mReader);
+        mWriter = nullptr;
+        mReader = nullptr;
+        return;
+    }
+
+    mWriterThread = std::jthread([this](std::stop_token stop) {
+        writerMain(stop);
+    });
+}
+
+LogDatabase::~LogDatabase() {
+    shutdown();
+}
+
+bool LogDatabase::open(const std::string& path) {
+    if (sqlite3_open_v2(path.c_str(), &mWriter, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX, nullptr) != SQLITE_OK) {
+        mError = sqlite3_errmsg(mWriter);
+        return false;
+    }
+
+    //
+    // WAL lets the reader run against the last commit while the writer
+    // appends. NORMAL sync is durable across application crashes, only a
+    // power loss can drop the most recent transactions.
+    //
+    if (!exec(mWriter, "PRAGMA journal_mode = WAL; PRAGMA synchronous = NORMAL; PRAGMA temp_store = MEMORY;", mError)) {
+        return false;
+    }
+
+    //
+    // The database is a cache of events fetched from CloudWatch, a file
+    // from an older version is emptied rather than migrated.
+    //
+    int version = 0;
+    sqlite3_stmt *stmt = nullptr;
+    if (sqlite3_prepare_v2(mWriter, "PRAGMA user_version", -1, &stmt, nullptr) == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW) {
+        version = sqlite3_column_int(stmt, 0);
+    }
+    sqlite3_finalize(stmt);
+
+    if (version != kSchemaVersion) {
+        std::string setVersion = std::format("PRAGMA user_version = {};", kSchemaVersion);
+        if (!exec(mWriter, kDropSchema, mError) || !exec(mWriter, setVersion.c_str(), mError)) {
+            return false;
+        }
+    }
+
+    if (!exec(mWriter, kSchema, mError)) {
+        return false;
+    }
+
+    std::string ftsError;
+    mHasFullTextSearch = exec(mWriter, kFullTextSchema, ftsError);
+
+    if (!prepareWriter()) {
+        return false;
+    }
+
+    if (sqlite3_open_v2(path.c_str(), &mReader, SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX, nullptr) != SQLITE_OK) {
+        mError = sqlite3_errmsg(mReader);
+        return false;
+    }
+
+    return true;
+}
+
+bool LogDatabase::prepareWriter() {
+    return prepare(mWriter, "INSERT OR IGNORE INTO log_groups (name) VALUES (?1)", &mInsertGroup, mError)
+        && prepare(mWriter, "SELECT id FROM log_groups WHERE name = ?1", &mSelectGroup, mError)
+        && prepare(mWriter, "INSERT OR IGNORE INTO log_streams (group_id, name) VALUES (?1, ?2)", &mInsertStream, mError)
+        && prepare(mWriter, "SELECT id FROM log_streams WHERE group_id = ?1 AND name = ?2", &mSelectStream, mError)
+        && prepare(mWriter, "INSERT OR IGNORE INTO events (group_id, stream_id, timestamp, hash, message) VALUES (?1, ?2, ?3, ?4, ?5)", &mInsertEvent, mError)
+        && (!mHasFullTextSearch || prepare(mWriter, "INSERT INTO events_text (rowid, message) VALUES (?1, ?2)", &mInsertText, mError));
+}
+
+int64_t LogDatabase::getGroupId(const std::string& logGroup) {
+    if (auto it = mGroupIds.find(logGroup); it != mGroupIds.end()) {
+        return it->second;
+    }
+
+    sqlite3_bind_text(mInsertGroup, 1, logGroup.data(), static_cast<int>(logGroup.size()), SQLITE_STATIC);
+    sqlite3_step(mInsertGroup);
+    sqlite3_reset(mInsertGroup);
+
+    int64_t id = 0;
+    sqlite3_bind_text(mSelectGroup, 1, logGroup.data(), static_cast<int>(logGroup.size()), SQLITE_STATIC);
+    if (sqlite3_step(mSelectGroup) == SQLITE_ROW) {
+        id = sqlite3_column_int64(mSelectGroup, 0);
+    }
+    sqlite3_reset(mSelectGroup);
+
+    mGroupIds.emplace(logGroup, id);
+    return id;
+}
+
+int64_t LogDatabase::getStreamId(int64_t groupId, const std::string& logStream) {
+    auto key = std::make_pair(groupId, logStream);
+    if (auto it = mStreamIds.find(key); it != mStreamIds.end()) {
+        return it->second;
+    }
+
+    sqlite3_bind_int64(mInsertStream, 1, groupId);
+    sqlite3_bind_text(mInsertStream, 2, logStream.data(), static_cast<int>(logStream.size()), SQLITE_STATIC);
+    sqlite3_step(mInsertStream);
+    sqlite3_reset(mInsertStream);
+
+    int64_t id = 0;
+    sqlite3_bind_int64(mSelectStream, 1, groupId);
+    sqlite3_bind_text(mSelectStream, 2, logStream.data(), static_cast<int>(logStream.size()), SQLITE_STATIC);
+    if (sqlite3_step(mSelectStream) == SQLITE_ROW) {
+        id = sqlite3_column_int64(mSelectStream, 0);
+    }
+    sqlite3_reset(mSelectStream);
+
+    mStreamIds.emplace(std::move(key), id);
+    return id;
+}
+
+void LogDatabase::writeBatch(const Batch& batch) {
+    int64_t groupId = getGroupId(batch.logGroup);
+
+    const LogChunk& events = *batch.events;
+
+    // Looked up once per batch, sources index batch.logStreams.
+    std::vector<int64_t> streamIds(batch.logStreams.size(), -1);
+    auto getSourceId = [&](uint32_t source) {
+        if (source >= streamIds.size()) {
+            streamIds.resize(source + 1, -1);
+        }
+        if (streamIds[source] < 0) {
+            streamIds[source] = getStreamId(groupId, source < batch.logStreams.size() ? batch.logStreams[source] : std::string{});
+        }
+        return streamIds[source];
+    };
+
+    uint64_t inserted = 0;
+    for (size_t i = batch.begin; i < batch.end; ++i) {
+        std::string_view message = events.getMessage(i);
+
+        sqlite3_bind_int64(mInsertEvent, 1, groupId);
+        sqlite3_bind_int64(mInsertEvent, 2, getSourceId(events.getSource(i)));
+        sqlite3_bind_int64(mInsertEvent, 3, events.getTimestamp(i));
+        sqlite3_bind_int64(mInsertEvent, 4, static_cast<int64_t>(hashMessage(message)));
+        sqlite3_bind_text(mInsertEvent, 5, message.data(), static_cast<int>(message.size()), SQLITE_STATIC);
+        int rc = sqlite3_step(mInsertEvent);
+        sqlite3_reset(mInsertEvent);
+
+        // Ignored duplicates change no rows, they are already indexed.
+        if (rc != SQLITE_DONE || sqlite3_changes(mWriter) == 0) {
+            continue;
+        }
+
+        inserted += 1;
+
+        if (mInsertText != nullptr) {
+            sqlite3_bind_int64(mInsertText, 1, sqlite3_last_insert_rowid(mWriter));
+            sqlite3_bind_text(mInsertText, 2, message.data(), static_cast<int>(message.size()), SQLITE_STATIC);
+            sqlite3_step(mInsertText);
+            sqlite3_reset(mInsertText);
+        }
+    }
+
+    mInsertedEvents.fetch_add(inserted, std::memory_order_relaxed);
+    mPendingEvents.fetch_sub(batch.end - batch.begin, std::memory_order_relaxed);
+}
+
+void LogDatabase::writerMain(std::stop_token stop) {
+    std::string error;
+    Batch batch;
+
+    while (true) {
+        {
+            std::unique_lock lock(mWakeMutex);
+            mWake.wait(lock, stop, [&] { return mPendingEvents.load() > 0; });
+        }
+
+        //
+        // One transaction per wakeup, bounded so a large backlog still
+        // commits regularly and readers see progress.
+        //
+        size_t written = 0;
+        bool isOpen = false;
+        while (written < kMaxTransactionEvents && mQueue.try_dequeue(batch)) {
+            if (!isOpen) {
+                isOpen = exec(mWriter, "BEGIN", error);
+            }
+
+            writeBatch(batch);
+            written += batch.end - batch.begin;
+
+            // Let the store pack into the chunk again.
+            batch.events.reset();
+        }
+
+        if (isOpen) {
+            exec(mWriter, "COMMIT", error);
+            mTransactions.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        if (stop.stop_requested() && mPendingEvents.load() == 0) {
+            break;
+        }
+    }
+}
+
+void LogDatabase::shutdown() {
+    if (mWriterThread.joinable()) {
+        mWriterThread.request_stop();
+        mWriterThread.join();
+    }
+
+    std::lock_guard lock(mReadMutex);
+
+    for (sqlite3_stmt *stmt : { mInsertGroup, mSelectGroup, mInsertStream, mSelectStream, mInsertEvent, mInsertText, mSearch }) {
+        sqlite3_finalize(stmt);
+    }
+
+    mInsertGroup = mSelectGroup = mInsertStream = mSelectStream = mInsertEvent = mInsertText = mSearch = nullptr;
+
+    sqlite3_close(mReader);
+    sqlite3_close(mWriter);
+    mReader = nullptr;
+    mWriter = nullptr;
+}
+
+void LogDatabase::configure(std::string path) {
+    std::lock_guard lock(gConfigureMutex);
+    gConfiguredPath = std::move(path);
+}
+
+LogDatabase& LogDatabase::get() {
+    static LogDatabase database{[] {
+        std::lock_guard lock(gConfigureMutex);
+        return gConfiguredPath;
+    }()};
+    return database;
+}
+
+void LogDatabase::insert(std::string logGroup, std::vector<std::string> logStreams, const SharedLogChunk& events, uint64_t from) {
+    size_t begin = static_cast<size_t>(std::max(from, events.first) - events.first);
+    if (!mWriterThread.joinable() || begin >= events.count) {
+        return;
+    }
+
+    mPendingEvents.fetch_add(events.count - begin, std::memory_order_relaxed);
+    mQueue.enqueue(Batch{std::move(logGroup), std::move(logStreams), events.chunk, begin, events.count});
+
+    std::lock_guard lock(mWakeMutex);
+    mWake.notify_one();
+}
+
+bool LogDatabase::search(const LogSearchQuery& query, LogChunk& out, std::string& error) {
+    if (mReader == nullptr) {
+        error = mError;
+        return false;
+    }
+
+    std::vector<std::string_view> words = splitWords(query.text);
+    std::string match = makeMatchExpression(words);
+
+    std::string sql = words.empty() ? kRangeSearch : mHasFullTextSearch ? kFullTextSearch : makeScanSearch(words.size());
+
+    std::lock_guard lock(mReadMutex);
+
+    //
+    // The searches differ only in SQL, keep the last one prepared as
+    // users tend to repeat the same kind of search.
+    //
+    if (mSearch == nullptr || sqlite3_sql(mSearch) != sql) {
+        sqlite3_finalize(mSearch);
+        mSearch = nullptr;
+        if (!prepare(mReader, sql.c_str(), &mSearch, error)) {
+            return false;
+        }
+    }
+
+    if (mHasFullTextSearch && !words.empty()) {
+        sqlite3_bind_text(mSearch, 1, match.data(), static_cast<int>(match.size()), SQLITE_STATIC);
+    } else {
+        for (size_t i = 0; i < words.size(); ++i) {
+            sqlite3_bind_text(mSearch, static_cast<int>(i) + 6, words[i].data(), static_cast<int>(words[i].size()), SQLITE_STATIC);
+        }
+    }
+
+    sqlite3_bind_text(mSearch, 2, query.logGroup.data(), static_cast<int>(query.logGroup.size()), SQLITE_STATIC);
+    sqlite3_bind_int64(mSearch, 3, query.start);
+    sqlite3_bind_int64(mSearch, 4, query.end);
+    sqlite3_bind_int64(mSearch, 5, static_cast<int64_t>(query.limit));
+
+    int rc;
+    while ((rc = sqlite3_step(mSearch)) == SQLITE_ROW) {
+        auto text = reinterpret_cast<const char*>(sqlite3_column_text(mSearch, 1));
+        int size = sqlite3_column_bytes(mSearch, 1);
+        out.push(sqlite3_column_int64(mSearch, 0), std::string_view{text, static_cast<size_t>(size)});
+    }
+
+    bool ok = rc == SQLITE_DONE;
+    if (!ok) {
+        error = sqlite3_errmsg(mReader);
+    }
+
+    sqlite3_reset(mSearch);
+    sqlite3_clear_bindings(mSearch);
+    return ok;
+}
+
+sm::LogDatabaseStats LogDatabase::getStats() const {
+    return LogDatabaseStats {
+        .insertedEvents = mInsertedEvents.load(),
+        .pendingEvents = mPendingEvents.load(),
+        .transactions = mTransactions.load(),
+    };
+}
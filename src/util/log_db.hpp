@@ -0,0 +1,132 @@
+#pragma once
+
+#include "util/log_store.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <concurrentqueue.h>
+
+struct sqlite3;
+struct sqlite3_stmt;
+
+namespace sm {
+    struct LogSearchQuery {
+        std::string logGroup;
+        std::string text; // words that must all appear, empty matches everything
+        int64_t start; // unix epoch milliseconds, inclusive
+        int64_t end; // unix epoch milliseconds, inclusive
+        size_t limit;
+    };
+
+    struct LogDatabaseStats {
+        uint64_t insertedEvents; // new events written since startup, duplicates excluded
+        uint64_t pendingEvents; // queued for the writer
+        uint64_t transactions;
+    };
+
+    //
+    // On disk store of every log event fetched, searchable without going
+    // back to CloudWatch. Events are deduplicated on log group, log stream,
+    // timestamp and a hash of the message, so fetching an overlapping range
+    // again only adds what is new.
+    //
+    // Writes are queued and applied by a writer thread with its own
+    // connection, each wakeup drains the queue into one transaction using
+    // prepared statements. The database runs in WAL mode, so searches on
+    // the read connection do not wait for the writer.
+    //
+    // Message text is indexed with an FTS5 external content table when the
+    // linked SQLite has FTS5. Otherwise searches fall back to scanning the
+    // time range with one instr() per word.
+    //
+    class LogDatabase {
+        struct Batch {
+            std::string logGroup;
+            std::vector<std::string> logStreams; // by event source
+            std::shared_ptr<const LogChunk> events; // shared with the store, never copied
+            size_t begin;
+            size_t end;
+        };
+
+        static constexpr size_t kMaxTransactionEvents = 100'000;
+
+        sqlite3 *mWriter = nullptr;
+        sqlite3 *mReader = nullptr;
+        bool mHasFullTextSearch = false;
+        std::string mError;
+
+        // Writer thread only.
+        sqlite3_stmt *mInsertGroup = nullptr;
+        sqlite3_stmt *mSelectGroup = nullptr;
+        sqlite3_stmt *mInsertStream = nullptr;
+        sqlite3_stmt *mSelectStream = nullptr;
+        sqlite3_stmt *mInsertEvent = nullptr;
+        sqlite3_stmt *mInsertText = nullptr;
+        std::unordered_map<std::string, int64_t> mGroupIds;
+        std::map<std::pair<int64_t, std::string>, int64_t> mStreamIds;
+
+        // Guarded by mReadMutex.
+        std::mutex mReadMutex;
+        sqlite3_stmt *mSearch = nullptr;
+
+        moodycamel::ConcurrentQueue<Batch> mQueue;
+        std::mutex mWakeMutex;
+        std::condition_variable_any mWake;
+        std::jthread mWriterThread;
+
+        std::atomic<uint64_t> mInsertedEvents{0};
+        std::atomic<uint64_t> mPendingEvents{0};
+        std::atomic<uint64_t> mTransactions{0};
+
+        bool open(const std::string& path);
+        bool prepareWriter();
+        int64_t getGroupId(const std::string& logGroup);
+        int64_t getStreamId(int64_t groupId, const std::string& logStream);
+        void writeBatch(const Batch& batch);
+        void writerMain(std::stop_token stop);
+
+        LogDatabase(const std::string& path);
+
+    public:
+        ~LogDatabase();
+
+        LogDatabase(const LogDatabase&) = delete;
+        LogDatabase& operator=(const LogDatabase&) = delete;
+
+        /// @brief Set the database path used when the shared database is opened.
+        ///        Has no effect once get() has been called.
+        static void configure(std::string path);
+
+        static LogDatabase& get();
+
+        /// @brief Flush queued events and close the database.
+        void shutdown();
+
+        bool isOpen() const { return mWriter != nullptr; }
+        const std::string& getError() const { return mError; }
+        bool hasFullTextSearch() const { return mHasFullTextSearch; }
+
+        /// @brief Queue the events of @p events with an id of @p from or
+        ///        later to be written under @p logGroup. The chunk is held,
+        ///        not copied, until the writer is done with it.
+        /// @param logStreams Stream names indexed by event source.
+        void insert(std::string logGroup, std::vector<std::string> logStreams, const SharedLogChunk& events, uint64_t from);
+
+        /// @brief Search stored events, blocking until done. Results are in
+        ///        timestamp order.
+        /// @return False with @p error set if the query failed.
+        bool search(const LogSearchQuery& query, LogChunk& out, std::string& error);
+
+        LogDatabaseStats getStats() const;
+    };
+}
@@ -0,0 +1,155 @@
+#include "log_fields.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <limits>
+
+using sm::LogFieldCache;
+
+namespace {
+    constexpr double kNoNumber = std::numeric_limits<double>::quiet_NaN();
+
+    double readNumber(std::string_view text, sm::JsonKind kind) {
+        switch (kind) {
+        case sm::JsonKind::eBool:
+            return text == "true" ? 1.0 : 0.0;
+
+        // Numbers are often logged as strings, "latency": "12.5" reads as a number too.
+        case sm::JsonKind::eNumber:
+        case sm::JsonKind::eString: {
+            double value = kNoNumber;
+            auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+            return (ec == std::errc{} && end == text.data() + text.size()) ? value : kNoNumber;
+        }
+
+        default:
+            return kNoNumber;
+        }
+    }
+}
+
+void LogFieldCache::setFields(std::span<const std::string> paths) {
+    mNames.clear();
+    mPaths.clear();
+    for (const std::string& path : paths) {
+        if (path.empty() || mNames.size() >= JsonPathSet::kMaxPaths) {
+            continue;
+        }
+
+        mNames.push_back(path);
+        mPaths.add(path);
+    }
+
+    clear();
+}
+
+void LogFieldCache::clear() {
+    mBase = 0;
+    mStart = 0;
+    mIsScanned.clear();
+    mSpans.clear();
+    mNumbers.clear();
+    mScanCount = 0;
+}
+
+void LogFieldCache::prune(const LogEventStore& store) {
+    uint64_t evicted = store.getEvictedCount();
+    if (evicted <= mBase) {
+        return;
+    }
+
+    size_t live = mIsScanned.size() - mStart;
+    size_t drop = static_cast<size_t>(std::min<uint64_t>(evicted - mBase, live));
+    mStart += drop;
+    mBase = evicted;
+
+    //
+    // Entries are dropped by moving mStart, the arrays are only compacted
+    // once most of them is dead so eviction stays amortised O(1) per event.
+    //
+    if (mStart > mIsScanned.size() / 2) {
+        size_t fields = mNames.size();
+        mIsScanned.erase(mIsScanned.begin(), mIsScanned.begin() + mStart);
+        mSpans.erase(mSpans.begin(), mSpans.begin() + mStart * fields);
+        mNumbers.erase(mNumbers.begin(), mNumbers.begin() + mStart * fields);
+        mStart = 0;
+    }
+}
+
+void LogFieldCache::scan(const LogEventStore& store, uint64_t id) {
+    size_t fields = mNames.size();
+    size_t slot = getSlot(id);
+
+    if (slot >= mIsScanned.size()) {
+        uint64_t end = store.getEvictedCount() + store.size();
+        size_t size = getSlot(end);
+        mIsScanned.resize(size, 0);
+        mSpans.resize(size * fields, JsonSpan{0, 0, JsonKind::eMissing});
+        mNumbers.resize(size * fields, kNoNumber);
+    }
+
+    if (mIsScanned[slot]) {
+        return;
+    }
+
+    mIsScanned[slot] = 1;
+    mScanCount += 1;
+
+    std::string_view message = store.at(static_cast<size_t>(id - store.getEvictedCount())).message;
+    size_t begin = message.find('{');
+    if (begin == std::string_view::npos) {
+        return;
+    }
+
+    std::string_view json = message.substr(begin);
+    std::span<JsonSpan> spans{mSpans.data() + slot * fields, fields};
+    scanJson(json, mPaths, spans);
+
+    for (size_t i = 0; i < fields; ++i) {
+        JsonSpan& span = spans[i];
+        if (span.kind == JsonKind::eMissing) {
+            continue;
+        }
+
+        mNumbers[slot * fields + i] = readNumber(span.get(json), span.kind);
+        span.offset += static_cast<uint32_t>(begin);
+    }
+}
+
+void LogFieldCache::update(const LogEventStore& store, uint64_t first, uint64_t last) {
+    if (mNames.empty()) {
+        return;
+    }
+
+    prune(store);
+
+    first = std::max(first, store.getEvictedCount());
+    last = std::min(last, store.getEvictedCount() + store.size());
+    for (uint64_t id = first; id < last; ++id) {
+        scan(store, id);
+    }
+}
+
+void LogFieldCache::update(const LogEventStore& store) {
+    update(store, store.getEvictedCount(), store.getEvictedCount() + store.size());
+}
+
+sm::JsonKind LogFieldCache::getKind(const LogEventStore& store, uint64_t id, size_t field) {
+    update(store, id, id + 1);
+    return mSpans[getSlot(id) * mNames.size() + field].kind;
+}
+
+std::string_view LogFieldCache::getText(const LogEventStore& store, uint64_t id, size_t field) {
+    update(store, id, id + 1);
+    const JsonSpan& span = mSpans[getSlot(id) * mNames.size() + field];
+    if (span.kind == JsonKind::eMissing) {
+        return {};
+    }
+
+    return span.get(store.at(static_cast<size_t>(id - store.getEvictedCount())).message);
+}
+
+double LogFieldCache::getNumber(const LogEventStore& store, uint64_t id, size_t field) {
+    update(store, id, id + 1);
+    return mNumbers[getSlot(id) * mNames.size() + field];
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "util/json_scan.hpp"
+#include "util/log_store.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sm {
+    //
+    // Typed columns of JSON fields pulled out of the events of a
+    // LogEventStore on demand. An event is scanned the first time any of
+    // its fields is asked for, which finds every field in one pass. The
+    // value spans and the numeric reading of each are kept, so sorting,
+    // filtering and plotting by a field never scan a message twice.
+    //
+    // Messages are read from the first '{', so events with a text prefix
+    // before their JSON body still work. Entries follow the store's event
+    // ids and are dropped as the store evicts.
+    //
+    class LogFieldCache {
+        std::vector<std::string> mNames;
+        JsonPathSet mPaths;
+
+        uint64_t mBase = 0; // id of the event at mStart
+        size_t mStart = 0; // first live entry, the ones before were evicted
+        std::vector<uint8_t> mIsScanned;
+        std::vector<JsonSpan> mSpans; // mNames.size() per event
+        std::vector<double> mNumbers; // as mSpans, NaN if not a number
+
+        uint64_t mScanCount = 0;
+
+        void prune(const LogEventStore& store);
+        void scan(const LogEventStore& store, uint64_t id);
+        size_t getSlot(uint64_t id) const { return mStart + static_cast<size_t>(id - mBase); }
+
+    public:
+        /// @brief Replace the fields, dotted paths such as "http.status".
+        void setFields(std::span<const std::string> paths);
+
+        /// @brief Forget every cached event, needed after the store is cleared.
+        void clear();
+
+        size_t getFieldCount() const { return mNames.size(); }
+        const std::string& getName(size_t field) const { return mNames[field]; }
+        bool empty() const { return mNames.empty(); }
+
+        /// @brief Scan every event in [@p first, @p last) not already scanned.
+        ///        Ids count from the first event since the store was cleared.
+        void update(const LogEventStore& store, uint64_t first, uint64_t last);
+
+        /// @brief Scan every event of @p store not already scanned.
+        void update(const LogEventStore& store);
+
+        JsonKind getKind(const LogEventStore& store, uint64_t id, size_t field);
+        std::string_view getText(const LogEventStore& store, uint64_t id, size_t field);
+        double getNumber(const LogEventStore& store, uint64_t id, size_t field);
+
+        /// @brief Messages scanned since the fields were set.
+        uint64_t getScanCount() const { return mScanCount; }
+    };
+}
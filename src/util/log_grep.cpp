@@ -0,0 +1,295 @@
+#include "log_grep.hpp"
+
+#include "util/executor.hpp"
+
+#include <algorithm>
+
+using sm::LogGrep;
+
+namespace {
+    // How often a chunk search checks for cancellation, in events.
+    constexpr size_t kStopCheckInterval = 4096;
+
+    // Punctuation that is matched literally when escaped.
+    bool isEscapedLiteral(char c) {
+        return std::string_view{"\\^$.|?*+()[]{}/-"}.find(c) != std::string_view::npos;
+    }
+
+    //
+    // The longest run of plain characters at the top level of an ECMAScript
+    // pattern, every match of the pattern contains it. Groups, classes,
+    // anchors and escapes like \d end a run. A character followed by an
+    // optional quantifier is dropped from the run, a pattern with any
+    // alternation has no required literal at all. This misses some literals
+    // but never returns one a match could lack.
+    //
+    std::string findRequiredLiteral(std::string_view pattern) {
+        std::string best;
+        std::string run;
+        int depth = 0;
+
+        auto endRun = [&] {
+            if (run.size() > best.size()) {
+                best = run;
+            }
+            run.clear();
+        };
+
+        for (size_t i = 0; i < pattern.size(); ++i) {
+            char c = pattern[i];
+            char literal = 0;
+
+            switch (c) {
+            case '\\':
+                if (i + 1 >= pattern.size()) {
+                    return {};
+                }
+
+                if (!isEscapedLiteral(pattern[i + 1])) {
+                    // \d, \b, \x41 and friends, skip the escape and whatever it consumes.
+                    char escape = pattern[++i];
+                    if (escape == 'x') {
+                        i += 2;
+                    } else if (escape == 'u') {
+                        i += 4;
+                    } else if (escape == 'c') {
+                        i += 1;
+                    }
+                    endRun();
+                    continue;
+                }
+
+                literal = pattern[++i];
+                break;
+
+            case '[':
+                // Skip the class, a leading ] or ^] is part of it.
+                i += 1;
+                if (i < pattern.size() && pattern[i] == '^') {
+                    i += 1;
+                }
+                if (i < pattern.size() && pattern[i] == ']') {
+                    i += 1;
+                }
+                while (i < pattern.size() && pattern[i] != ']') {
+                    i += (pattern[i] == '\\') ? 2 : 1;
+                }
+                endRun();
+                continue;
+
+            case '|':
+                return {};
+
+            case '(':
+                depth += 1;
+                endRun();
+                continue;
+
+            case ')':
+                depth -= 1;
+                endRun();
+                continue;
+
+            case '.': case '^': case '$':
+                endRun();
+                continue;
+
+            case '*': case '?': case '{':
+                // The atom before may not appear at all.
+                if (!run.empty()) {
+                    run.pop_back();
+                }
+                if (c == '{') {
+                    while (i < pattern.size() && pattern[i] != '}') {
+                        i += 1;
+                    }
+                }
+                endRun();
+                continue;
+
+            case '+':
+                endRun();
+                continue;
+
+            default:
+                literal = c;
+                break;
+            }
+
+            // Literals inside a group are skipped, the group may be optional.
+            if (depth == 0) {
+                run += literal;
+            }
+        }
+
+        endRun();
+        return best;
+    }
+}
+
+LogGrep::~LogGrep() {
+    cancel();
+}
+
+bool LogGrep::start(const GrepOptions& options) {
+    cancel();
+
+    if (options.pattern.empty()) {
+        return true;
+    }
+
+    auto matcher = std::make_shared<Matcher>();
+
+    if (options.isRegex) {
+        auto flags = std::regex::ECMAScript | std::regex::optimize | std::regex::nosubs;
+        if (options.ignoreCase) {
+            flags |= std::regex::icase;
+        }
+
+        // std::regex reports a bad pattern by throwing, keep that from leaking out.
+        try {
+            matcher->regex.emplace(options.pattern, flags);
+        } catch (const std::regex_error& error) {
+            mError = error.what();
+            return false;
+        }
+
+        matcher->literal = LiteralSearch(findRequiredLiteral(options.pattern), options.ignoreCase);
+    } else {
+        matcher->literal = LiteralSearch(options.pattern, options.ignoreCase);
+    }
+
+    mMatcher = std::move(matcher);
+    return true;
+}
+
+void LogGrep::cancel() {
+    rewind();
+    mMatcher.reset();
+    mError.clear();
+}
+
+void LogGrep::rewind() {
+    mStop.request_stop();
+    mStop = std::stop_source{};
+    mGeneration += 1;
+
+    mSubmittedEnd = 0;
+    mPendingTasks = 0;
+    mSearchedEvents = 0;
+    mMatches.clear();
+    mAdded.clear();
+}
+
+void LogGrep::submit(SharedLogChunk shared, uint64_t from) {
+    mPendingTasks += 1;
+
+    sm::Executor::get().submit(mStop, [state = mShared, generation = mGeneration, matcher = mMatcher, shared = std::move(shared), from](std::stop_token stop) {
+        const LogChunk& chunk = *shared.chunk;
+        size_t begin = static_cast<size_t>(from - shared.first);
+        size_t end = shared.count;
+
+        Result result{generation, end - begin};
+
+        auto isMatch = [&](size_t event) {
+            if (!matcher->regex) {
+                return true;
+            }
+
+            std::string_view message = chunk.getMessage(event);
+            return std::regex_search(message.begin(), message.end(), *matcher->regex);
+        };
+
+        if (matcher->literal.empty()) {
+            for (size_t i = begin; i < end; ++i) {
+                if ((i - begin) % kStopCheckInterval == 0 && stop.stop_requested()) {
+                    return;
+                }
+
+                if (isMatch(i)) {
+                    result.matches.push_back(shared.first + i);
+                }
+            }
+        } else {
+            //
+            // Scan the packed text of every event in one pass, a hit is
+            // mapped back to its event and the scan resumes after it.
+            //
+            std::string_view text = chunk.getText().substr(0, chunk.getOffset(end));
+            size_t offset = chunk.getOffset(begin);
+            size_t checked = 0;
+
+            while ((offset = matcher->literal.find(text, offset)) != std::string_view::npos) {
+                size_t event = chunk.findEvent(offset);
+                size_t eventEnd = chunk.getOffset(event + 1);
+
+                // The hit runs into the next event, try again one byte on.
+                if (offset + matcher->literal.size() > eventEnd) {
+                    offset += 1;
+                    continue;
+                }
+
+                if (isMatch(event)) {
+                    result.matches.push_back(shared.first + event);
+                }
+
+                offset = eventEnd;
+
+                if (++checked % kStopCheckInterval == 0 && stop.stop_requested()) {
+                    return;
+                }
+            }
+        }
+
+        state->results.enqueue(std::move(result));
+    });
+}
+
+size_t LogGrep::poll(const LogEventStore& store) {
+    if (mMatcher == nullptr) {
+        return 0;
+    }
+
+    mAdded.clear();
+
+    Result result;
+    while (mShared->results.try_dequeue(result)) {
+        if (result.generation != mGeneration) {
+            continue;
+        }
+
+        mPendingTasks -= 1;
+        mSearchedEvents += result.searched;
+
+        // Chunks finish out of order but never overlap.
+        if (!result.matches.empty()) {
+            auto at = std::upper_bound(mMatches.begin(), mMatches.end(), result.matches.front());
+            mMatches.insert(at, result.matches.begin(), result.matches.end());
+
+            at = std::upper_bound(mAdded.begin(), mAdded.end(), result.matches.front());
+            mAdded.insert(at, result.matches.begin(), result.matches.end());
+        }
+    }
+
+    uint64_t evicted = store.getEvictedCount();
+    auto firstKept = std::lower_bound(mMatches.begin(), mMatches.end(), evicted);
+    size_t dropped = static_cast<size_t>(firstKept - mMatches.begin());
+    mMatches.erase(mMatches.begin(), firstKept);
+    mAdded.erase(mAdded.begin(), std::lower_bound(mAdded.begin(), mAdded.end(), evicted));
+
+    uint64_t from = std::max(mSubmittedEnd, evicted);
+
+    mScratch.clear();
+    store.share(from, mScratch);
+    for (SharedLogChunk& shared : mScratch) {
+        uint64_t chunkFrom = std::max(from, shared.first);
+        mSubmittedEnd = shared.first + shared.count;
+        submit(std::move(shared), chunkFrom);
+    }
+
+    return dropped;
+}
+
+std::string_view LogGrep::getLiteral() const {
+    return mMatcher != nullptr ? mMatcher->literal.getNeedle() : std::string_view{};
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "util/literal_search.hpp"
+#include "util/log_store.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <regex>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <vector>
+#include <concurrentqueue.h>
+
+namespace sm {
+    struct GrepOptions {
+        std::string pattern;
+        bool isRegex = false;
+        bool ignoreCase = true;
+    };
+
+    //
+    // Searches the events of a LogEventStore on the Executor, one task per
+    // stored chunk. Each task first scans the chunk's packed text for a
+    // literal every match must contain with a LiteralSearch, then runs the
+    // regex only on the events it hits. A regex with no such literal is run
+    // on every event.
+    //
+    // Matches are merged on the UI thread in poll() as each chunk finishes,
+    // so the first ones show up long before the whole store is searched.
+    // Events appended to the store later are searched by the next poll().
+    //
+    class LogGrep {
+        struct Matcher {
+            LiteralSearch literal;
+            std::optional<std::regex> regex;
+        };
+
+        struct Result {
+            uint32_t generation;
+            uint64_t searched;
+            std::vector<uint64_t> matches; // event ids, ascending
+        };
+
+        struct State {
+            moodycamel::ConcurrentQueue<Result> results;
+        };
+
+        std::shared_ptr<State> mShared = std::make_shared<State>();
+        std::stop_source mStop;
+        uint32_t mGeneration = 0;
+
+        std::shared_ptr<const Matcher> mMatcher;
+        uint64_t mSubmittedEnd = 0; // events before this id have been submitted
+        size_t mPendingTasks = 0;
+        uint64_t mSearchedEvents = 0;
+        std::vector<uint64_t> mMatches; // event ids, ascending
+        std::vector<uint64_t> mAdded; // matches merged by the last poll, ascending
+        std::vector<SharedLogChunk> mScratch;
+
+        std::string mError;
+
+        void submit(SharedLogChunk chunk, uint64_t from);
+
+    public:
+        ~LogGrep();
+
+        /// @brief Search for @p options.pattern, replacing any previous search.
+        ///        An empty pattern cancels the search.
+        /// @return False with error() set if the pattern is not a valid regex.
+        bool start(const GrepOptions& options);
+
+        /// @brief Stop searching and drop every match.
+        void cancel();
+
+        /// @brief Search the store again from its first event, keeping the
+        ///        pattern. Needed after the store is cleared.
+        void rewind();
+
+        /// @brief Merge finished chunks, drop matches the store has evicted,
+        ///        and start searching events added since the last poll.
+        /// @return The number of matches dropped from the front.
+        size_t poll(const LogEventStore& store);
+
+        bool isActive() const { return mMatcher != nullptr; }
+        bool isWorking() const { return mPendingTasks > 0; }
+
+        /// @brief Ids of matching events, subtract getEvictedCount() of the
+        ///        store for an index.
+        std::span<const uint64_t> getMatches() const { return mMatches; }
+
+        /// @brief Ids of the matches merged by the last poll(), ascending.
+        ///        Lets views built from the matches update incrementally.
+        std::span<const uint64_t> getAdded() const { return mAdded; }
+
+        /// @brief Changes whenever the matches are dropped and searched for
+        ///        again, rather than only added to.
+        uint32_t getGeneration() const { return mGeneration; }
+        uint64_t getSearchedCount() const { return mSearchedEvents; }
+
+        /// @brief The literal used to skip events, empty if every event is
+        ///        checked against the regex.
+        std::string_view getLiteral() const;
+
+        bool hasError() const { return !mError.empty(); }
+        const std::string& error() const { return mError; }
+    };
+}
@@ -0,0 +1,103 @@
+#include "log_merge.hpp"
+
+#include <algorithm>
+#include <queue>
+
+using sm::LogMerger;
+
+void LogMerger::advance(Run& run) {
+    run.index += 1;
+    run.buffered -= 1;
+    mBuffered -= 1;
+
+    if (run.index == run.chunks.front().size()) {
+        run.chunks.pop_front();
+        run.index = 0;
+    }
+}
+
+size_t LogMerger::addRun(int64_t watermark) {
+    mRuns.push_back(Run{.watermark = watermark});
+    return mRuns.size() - 1;
+}
+
+void LogMerger::push(size_t run, LogChunk chunk) {
+    if (chunk.empty()) {
+        return;
+    }
+
+    Run& target = mRuns[run];
+    target.buffered += chunk.size();
+    mBuffered += chunk.size();
+    target.chunks.push_back(std::move(chunk));
+}
+
+void LogMerger::advanceWatermark(size_t run, int64_t watermark) {
+    Run& target = mRuns[run];
+    target.watermark = std::max(target.watermark, watermark);
+}
+
+void LogMerger::finish(size_t run) {
+    mRuns[run].finished = true;
+}
+
+void LogMerger::setIdle(size_t run, bool idle) {
+    mRuns[run].idle = idle;
+}
+
+void LogMerger::clear() {
+    mRuns.clear();
+    mBuffered = 0;
+}
+
+size_t LogMerger::drain(LogChunk& out, size_t maxEvents) {
+    struct Head {
+        int64_t timestamp;
+        size_t run;
+
+        bool operator>(const Head& other) const {
+            return timestamp != other.timestamp ? timestamp > other.timestamp : run > other.run;
+        }
+    };
+
+    //
+    // Runs with nothing buffered that are still open and not idle bound
+    // what can be released, they may yet deliver anything from their
+    // watermark on.
+    //
+    int64_t bound = kNoWatermark;
+    std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+    for (size_t i = 0; i < mRuns.size(); ++i) {
+        const Run& run = mRuns[i];
+        if (run.buffered > 0) {
+            heads.push(Head{run.chunks.front().getTimestamp(run.index), i});
+        } else if (!run.finished && !run.idle) {
+            bound = std::min(bound, run.watermark);
+        }
+    }
+
+    size_t moved = 0;
+    while (moved < maxEvents && !heads.empty()) {
+        Head head = heads.top();
+        if (head.timestamp > bound) {
+            break;
+        }
+
+        heads.pop();
+
+        Run& run = mRuns[head.run];
+        const LogChunk& chunk = run.chunks.front();
+        out.push(head.timestamp, chunk.getMessage(run.index), chunk.getSource(run.index));
+        run.watermark = std::max(run.watermark, head.timestamp);
+        advance(run);
+        moved += 1;
+
+        if (run.buffered > 0) {
+            heads.push(Head{run.chunks.front().getTimestamp(run.index), head.run});
+        } else if (!run.finished && !run.idle) {
+            bound = std::min(bound, run.watermark);
+        }
+    }
+
+    return moved;
+}
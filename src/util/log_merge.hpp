@@ -0,0 +1,67 @@
+#pragma once
+
+#include "util/log_store.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <vector>
+
+namespace sm {
+    //
+    // K-way merge of timestamp ordered runs of log events into one ordered
+    // sequence. Each run has a watermark, a lower bound on the timestamp of
+    // anything it may still produce. An event is only released once no run
+    // could later produce an earlier one, so runs that are slow to deliver
+    // hold back the output rather than having their events arrive late.
+    //
+    class LogMerger {
+        struct Run {
+            std::deque<LogChunk> chunks;
+            size_t index = 0; // next event in chunks.front()
+            size_t buffered = 0;
+            int64_t watermark;
+            bool finished = false;
+            bool idle = false;
+        };
+
+        std::vector<Run> mRuns;
+        size_t mBuffered = 0;
+
+        void advance(Run& run);
+
+    public:
+        static constexpr int64_t kNoWatermark = std::numeric_limits<int64_t>::max();
+
+        /// @brief Add a run whose events will all be at or after @p watermark.
+        /// @return The id of the run.
+        size_t addRun(int64_t watermark);
+
+        /// @brief Queue events for @p run, @p chunk must be sorted by timestamp.
+        void push(size_t run, LogChunk chunk);
+
+        /// @brief Raise the watermark of @p run, used when a source reports
+        ///        that it has nothing older than @p watermark left to send.
+        void advanceWatermark(size_t run, int64_t watermark);
+
+        /// @brief Mark @p run as complete, it no longer holds back other runs.
+        void finish(size_t run);
+
+        /// @brief An idle run is not expected to produce anything soon and
+        ///        does not hold back other runs while it has nothing buffered.
+        ///        Events it does produce are released as soon as they arrive,
+        ///        even if later events from other runs were already released.
+        void setIdle(size_t run, bool idle);
+
+        void clear();
+
+        /// @brief Move up to @p maxEvents releasable events into @p out in order.
+        /// @return The number of events moved.
+        size_t drain(LogChunk& out, size_t maxEvents = std::numeric_limits<size_t>::max());
+
+        size_t getRunCount() const { return mRuns.size(); }
+        size_t getBufferedCount() const { return mBuffered; }
+        size_t getBufferedCount(size_t run) const { return mRuns[run].buffered; }
+        bool isFinished(size_t run) const { return mRuns[run].finished; }
+    };
+}
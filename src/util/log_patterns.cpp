@@ -0,0 +1,218 @@
+#include "log_patterns.hpp"
+
+#include "util/executor.hpp"
+
+#include <algorithm>
+
+using sm::LogPatternMiner;
+
+namespace {
+    constexpr std::string_view kWildcard = "<*>";
+
+    bool hasDigit(std::string_view token) {
+        return std::any_of(token.begin(), token.end(), [](char c) { return c >= '0' && c <= '9'; });
+    }
+
+    bool isSpace(char c) {
+        return c == ' ' || c == '\t';
+    }
+}
+
+std::string_view LogPatternMiner::Clusters::intern(std::string_view token) {
+    return tokenPool->intern(token).view();
+}
+
+uint32_t LogPatternMiner::Clusters::findLeaf(std::span<const std::string_view> tokens) {
+    auto [it, isNew] = lengthNodes.try_emplace(tokens.size(), static_cast<uint32_t>(nodes.size()));
+    if (isNew) {
+        nodes.emplace_back();
+    }
+
+    uint32_t node = it->second;
+    for (size_t depth = 0; depth < std::min(kDepth, tokens.size()); ++depth) {
+        std::string_view key = tokens[depth];
+
+        auto& children = nodes[node].children;
+        if (auto child = children.find(key); child != children.end()) {
+            node = child->second;
+            continue;
+        }
+
+        //
+        // Unknown tokens share a wildcard branch once a node is full, so a
+        // variable in a leading position can't grow the tree without bound.
+        //
+        if (children.size() + 1 >= kMaxChildren && key != kWildcard) {
+            key = kWildcard;
+            if (auto child = children.find(key); child != children.end()) {
+                node = child->second;
+                continue;
+            }
+        }
+
+        uint32_t next = static_cast<uint32_t>(nodes.size());
+        nodes[node].children.emplace(intern(key), next);
+        nodes.emplace_back();
+        node = next;
+    }
+
+    return node;
+}
+
+void LogPatternMiner::Clusters::add(std::string_view message) {
+    std::string_view line = message.substr(0, message.find_first_of("\r\n"));
+
+    messageTokens.clear();
+    size_t i = 0;
+    while (i < line.size() && messageTokens.size() < kMaxTokens) {
+        while (i < line.size() && isSpace(line[i])) {
+            i += 1;
+        }
+
+        size_t begin = i;
+        while (i < line.size() && !isSpace(line[i])) {
+            i += 1;
+        }
+
+        if (i > begin) {
+            std::string_view token = line.substr(begin, i - begin);
+            messageTokens.push_back(hasDigit(token) ? kWildcard : token);
+        }
+    }
+
+    Node& leaf = nodes[findLeaf(messageTokens)];
+
+    //
+    // Similarity counts exact token matches, a wildcard in the template
+    // doesn't count. Ties go to the template with more wildcards, which
+    // has already absorbed more variation.
+    //
+    uint32_t best = UINT32_MAX;
+    size_t bestEqual = 0;
+    size_t bestWildcards = 0;
+    for (uint32_t pattern : leaf.patterns) {
+        const auto& tokens = templates[pattern];
+
+        size_t equal = 0;
+        size_t wildcards = 0;
+        for (size_t t = 0; t < tokens.size(); ++t) {
+            if (tokens[t] == kWildcard) {
+                wildcards += 1;
+            } else if (tokens[t] == messageTokens[t]) {
+                equal += 1;
+            }
+        }
+
+        if (best == UINT32_MAX || equal > bestEqual || (equal == bestEqual && wildcards > bestWildcards)) {
+            best = pattern;
+            bestEqual = equal;
+            bestWildcards = wildcards;
+        }
+    }
+
+    bool isSimilar = best != UINT32_MAX
+        && (messageTokens.empty() || static_cast<double>(bestEqual) >= kSimilarity * static_cast<double>(messageTokens.size()));
+
+    if (!isSimilar) {
+        best = static_cast<uint32_t>(templates.size());
+        leaf.patterns.push_back(best);
+
+        auto& tokens = templates.emplace_back();
+        for (std::string_view token : messageTokens) {
+            tokens.push_back(intern(token));
+        }
+        patterns.push_back(LogPattern{{}, 0, 0});
+    } else {
+        bool changed = false;
+        auto& tokens = templates[best];
+        for (size_t t = 0; t < tokens.size(); ++t) {
+            if (tokens[t] != kWildcard && tokens[t] != messageTokens[t]) {
+                tokens[t] = kWildcard;
+                changed = true;
+            }
+        }
+
+        if (!changed) {
+            patterns[best].events += 1;
+            patterns[best].bytes += message.size();
+            return;
+        }
+    }
+
+    LogPattern& pattern = patterns[best];
+    pattern.events += 1;
+    pattern.bytes += message.size();
+    pattern.text.clear();
+    for (std::string_view token : templates[best]) {
+        if (!pattern.text.empty()) {
+            pattern.text += ' ';
+        }
+        pattern.text += token;
+    }
+}
+
+void LogPatternMiner::run(std::shared_ptr<State> state) {
+    sm::Executor::get().submit([state = std::move(state)](std::stop_token) {
+        Batch batch;
+        while (true) {
+            bool isChanged = false;
+            while (state->batches.try_dequeue(batch)) {
+                size_t end = batch.events.count;
+
+                const LogChunk& chunk = *batch.events.chunk;
+                for (size_t i = batch.begin; i < end; ++i) {
+                    state->clusters.add(chunk.getMessage(i));
+                }
+                isChanged = true;
+
+                state->pendingEvents.fetch_sub(end - batch.begin, std::memory_order_relaxed);
+
+                // Let the store pack into the chunk again.
+                batch = Batch{};
+            }
+
+            if (isChanged) {
+                std::lock_guard lock(state->publishMutex);
+                state->published = state->clusters.patterns;
+                state->publishedVersion += 1;
+            }
+
+            //
+            // A batch queued after the last dequeue but before isRunning is
+            // cleared saw the task still running, pick it up here.
+            //
+            state->isRunning.store(false);
+            if (state->batches.size_approx() == 0 || state->isRunning.exchange(true)) {
+                return;
+            }
+        }
+    });
+}
+
+void LogPatternMiner::add(const SharedLogChunk& events, uint64_t from) {
+    size_t begin = static_cast<size_t>(std::max(from, events.first) - events.first);
+    if (begin >= events.count) {
+        return;
+    }
+
+    mShared->pendingEvents.fetch_add(events.count - begin, std::memory_order_relaxed);
+    mShared->batches.enqueue(Batch{events, begin});
+
+    if (!mShared->isRunning.exchange(true)) {
+        run(mShared);
+    }
+}
+
+void LogPatternMiner::poll() {
+    std::lock_guard lock(mShared->publishMutex);
+    if (mShared->publishedVersion != mVersion) {
+        mPatterns = mShared->published;
+        mVersion = mShared->publishedVersion;
+    }
+}
+
+void LogPatternMiner::clear() {
+    mShared = std::make_shared<State>();
+    mPatterns.clear();
+    mVersion = 0;
+}
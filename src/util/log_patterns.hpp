@@ -0,0 +1,113 @@
+#pragma once
+
+#include "util/intern.hpp"
+#include "util/log_store.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <concurrentqueue.h>
+
+namespace sm {
+    struct LogPattern {
+        std::string text; // tokens joined by spaces, variable tokens as <*>
+        uint64_t events;
+        uint64_t bytes;
+    };
+
+    //
+    // Groups log messages into templates online, after Drain. A message is
+    // split into whitespace separated tokens, a token holding a digit is
+    // taken as a variable straight away. The tokens then walk a fixed depth
+    // prefix tree, first by token count, then by the leading kDepth tokens.
+    // The leaf holds candidate templates of that shape. The message joins
+    // the most similar one, and tokens where the two differ become
+    // wildcards, or starts a new template if none is close enough.
+    //
+    // Only the first line of a message is clustered, up to kMaxTokens tokens.
+    // Template tokens are interned, every template and tree key shares one
+    // copy of each distinct token.
+    //
+    // Chunks are handed over as they are drained into a LogEventStore, so
+    // every event is counted even if the store evicts it soon after. They
+    // are clustered in order by one task at a time on the Executor, which
+    // publishes a copy of the patterns when it runs out of chunks. poll()
+    // picks up the latest copy on the UI thread.
+    //
+    class LogPatternMiner {
+        static constexpr size_t kDepth = 2;
+        static constexpr size_t kMaxChildren = 100;
+        static constexpr size_t kMaxTokens = 64;
+
+        // Share of tokens a message must have in common with a template to join it.
+        static constexpr double kSimilarity = 0.5;
+
+        struct Node {
+            std::unordered_map<std::string_view, uint32_t> children;
+            std::vector<uint32_t> patterns;
+        };
+
+        // The clustering itself, only touched by the task that owns it.
+        struct Clusters {
+            std::unique_ptr<StringPool> tokenPool = std::make_unique<StringPool>();
+            std::vector<Node> nodes;
+            std::unordered_map<size_t, uint32_t> lengthNodes;
+            std::vector<std::vector<std::string_view>> templates;
+            std::vector<LogPattern> patterns;
+            std::vector<std::string_view> messageTokens;
+
+            std::string_view intern(std::string_view token);
+            uint32_t findLeaf(std::span<const std::string_view> tokens);
+            void add(std::string_view message);
+        };
+
+        struct Batch {
+            SharedLogChunk events;
+            size_t begin;
+        };
+
+        //
+        // Replaced whole by clear(), a task still running on the old one
+        // finishes its batches unseen.
+        //
+        struct State {
+            moodycamel::ConcurrentQueue<Batch> batches;
+            std::atomic<bool> isRunning{false};
+            std::atomic<uint64_t> pendingEvents{0};
+
+            Clusters clusters; // task only
+
+            std::mutex publishMutex;
+            std::vector<LogPattern> published;
+            uint64_t publishedVersion = 0;
+        };
+
+        std::shared_ptr<State> mShared = std::make_shared<State>();
+        std::vector<LogPattern> mPatterns;
+        uint64_t mVersion = 0;
+
+        static void run(std::shared_ptr<State> state);
+
+    public:
+        /// @brief Queue the events of @p events with an id of @p from or
+        ///        later to be clustered. The chunk is held, not copied.
+        void add(const SharedLogChunk& events, uint64_t from);
+
+        /// @brief Pick up the patterns published since the last poll.
+        void poll();
+
+        /// @brief Forget every pattern, needed after the store is cleared.
+        void clear();
+
+        /// @brief Events handed over but not clustered yet.
+        uint64_t getBacklog() const { return mShared->pendingEvents.load(std::memory_order_relaxed); }
+
+        std::span<const LogPattern> getPatterns() const { return mPatterns; }
+    };
+}
@@ -0,0 +1,91 @@
+#include "log_store.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+using sm::LogEventStore;
+
+void LogEventStore::evict() {
+    //
+    // The newest chunk is always kept, even on its own it may exceed a
+    // very small cap.
+    //
+    while (mMemoryUsage > mMemoryCap && mChunks.size() > 1) {
+        const StoredChunk& front = mChunks.front();
+        mMemoryUsage -= front.chunk->getMemoryUsage();
+        mFirstEvent = front.first + front.chunk->size();
+        mChunks.pop_front();
+    }
+}
+
+const LogEventStore::StoredChunk& LogEventStore::findChunk(uint64_t id) const {
+    auto it = std::partition_point(mChunks.begin(), mChunks.end(), [id](const StoredChunk& stored) {
+        return stored.first + stored.chunk->size() <= id;
+    });
+
+    return *it;
+}
+
+void LogEventStore::append(LogChunk chunk) {
+    if (chunk.empty()) {
+        return;
+    }
+
+    size_t count = chunk.size();
+
+    //
+    // Only this thread hands out references, so a use count of one means
+    // no reader can be looking at the chunk while it grows. use_count() is
+    // a relaxed load though, the acquire fence orders our writes after the
+    // last read made by the worker that dropped its reference.
+    //
+    if (!mChunks.empty()) {
+        StoredChunk& back = mChunks.back();
+        if (back.chunk.use_count() == 1 && back.chunk->getByteCount() + chunk.getByteCount() <= kTargetChunkBytes) {
+            std::atomic_thread_fence(std::memory_order_acquire);
+            mMemoryUsage -= back.chunk->getMemoryUsage();
+            back.chunk->append(chunk);
+            mMemoryUsage += back.chunk->getMemoryUsage();
+            mEndEvent += count;
+            evict();
+            return;
+        }
+    }
+
+    mMemoryUsage += chunk.getMemoryUsage();
+    mChunks.push_back(StoredChunk{mEndEvent, std::make_shared<LogChunk>(std::move(chunk))});
+    mEndEvent += count;
+    evict();
+}
+
+void LogEventStore::clear() {
+    mChunks.clear();
+    mFirstEvent = 0;
+    mEndEvent = 0;
+    mMemoryUsage = 0;
+}
+
+void LogEventStore::setMemoryCap(size_t bytes) {
+    mMemoryCap = bytes;
+    evict();
+}
+
+sm::LogEventView LogEventStore::at(size_t i) const {
+    uint64_t id = mFirstEvent + i;
+    const StoredChunk& stored = findChunk(id);
+    return stored.chunk->at(static_cast<size_t>(id - stored.first));
+}
+
+void LogEventStore::share(uint64_t from, std::vector<SharedLogChunk>& out) const {
+    if (from >= mEndEvent) {
+        return;
+    }
+
+    auto it = std::partition_point(mChunks.begin(), mChunks.end(), [from](const StoredChunk& stored) {
+        return stored.first + stored.chunk->size() <= from;
+    });
+
+    for (; it != mChunks.end(); ++it) {
+        out.push_back(SharedLogChunk{it->first, it->chunk->size(), it->chunk});
+    }
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace sm {
+    struct LogEventView {
+        int64_t timestamp; // unix epoch milliseconds
+        std::string_view message;
+        uint32_t source; // caller defined, such as an index into a list of log streams
+    };
+
+    //
+    // A run of log events with every message packed into one byte buffer.
+    // Message i spans [mOffsets[i], mOffsets[i + 1]) of mBytes. Chunks are
+    // filled on worker threads then handed whole to a LogEventStore.
+    //
+    class LogChunk {
+        std::vector<char> mBytes;
+        std::vector<uint32_t> mOffsets{0};
+        std::vector<int64_t> mTimestamps;
+        std::vector<uint32_t> mSources;
+
+    public:
+        void reserve(size_t events, size_t bytes) {
+            mBytes.reserve(bytes);
+            mOffsets.reserve(events + 1);
+            mTimestamps.reserve(events);
+            mSources.reserve(events);
+        }
+
+        void push(int64_t timestamp, std::string_view message, uint32_t source = 0) {
+            mBytes.insert(mBytes.end(), message.begin(), message.end());
+            mOffsets.push_back(static_cast<uint32_t>(mBytes.size()));
+            mTimestamps.push_back(timestamp);
+            mSources.push_back(source);
+        }
+
+        /// @brief Copy every event of @p other onto the end of this chunk.
+        void append(const LogChunk& other) {
+            uint32_t base = static_cast<uint32_t>(mBytes.size());
+            mBytes.insert(mBytes.end(), other.mBytes.begin(), other.mBytes.end());
+            for (size_t i = 1; i < other.mOffsets.size(); ++i) {
+                mOffsets.push_back(base + other.mOffsets[i]);
+            }
+            mTimestamps.insert(mTimestamps.end(), other.mTimestamps.begin(), other.mTimestamps.end());
+            mSources.insert(mSources.end(), other.mSources.begin(), other.mSources.end());
+        }
+
+        size_t size() const { return mTimestamps.size(); }
+        bool empty() const { return mTimestamps.empty(); }
+
+        /// @brief Bytes held by the chunk including its offset tables.
+        size_t getMemoryUsage() const {
+            return mBytes.capacity()
+                + mOffsets.capacity() * sizeof(uint32_t)
+                + mTimestamps.capacity() * sizeof(int64_t)
+                + mSources.capacity() * sizeof(uint32_t);
+        }
+
+        size_t getByteCount() const { return mBytes.size(); }
+
+        /// @brief Every message back to back, event i starts at getOffset(i).
+        std::string_view getText() const { return std::string_view{mBytes.data(), mBytes.size()}; }
+        size_t getOffset(size_t i) const { return mOffsets[i]; }
+
+        /// @brief Index of the event whose message contains byte @p offset of getText().
+        size_t findEvent(size_t offset) const {
+            auto it = std::upper_bound(mOffsets.begin(), mOffsets.end(), offset);
+            return static_cast<size_t>(it - mOffsets.begin()) - 1;
+        }
+
+        int64_t getTimestamp(size_t i) const { return mTimestamps[i]; }
+        uint32_t getSource(size_t i) const { return mSources[i]; }
+
+        std::string_view getMessage(size_t i) const {
+            return std::string_view{mBytes.data() + mOffsets[i], mOffsets[i + 1] - mOffsets[i]};
+        }
+
+        LogEventView at(size_t i) const {
+            return LogEventView{getTimestamp(i), getMessage(i), getSource(i)};
+        }
+    };
+
+    struct SharedLogChunk {
+        uint64_t first; // id of the first event in the chunk
+        size_t count; // events in the chunk when it was shared
+        std::shared_ptr<const LogChunk> chunk;
+    };
+
+    //
+    // Append only store of log events made of LogChunks. Small chunks are
+    // packed together so each stored chunk is close to kTargetChunkBytes,
+    // once the memory cap is exceeded whole chunks are evicted from the
+    // front. Event indices passed to at() are relative to the oldest event
+    // still retained, getEvictedCount tells how far that has moved.
+    //
+    // Chunks can be shared with other threads for reading. A chunk that is
+    // still shared is never packed into, new events go to a fresh chunk.
+    //
+    class LogEventStore {
+        static constexpr size_t kTargetChunkBytes = 1024 * 1024;
+
+        struct StoredChunk {
+            uint64_t first; // id of the first event in this chunk
+            std::shared_ptr<LogChunk> chunk;
+        };
+
+        std::deque<StoredChunk> mChunks;
+        uint64_t mFirstEvent = 0;
+        uint64_t mEndEvent = 0;
+        size_t mMemoryUsage = 0;
+        size_t mMemoryCap;
+
+        void evict();
+
+        const StoredChunk& findChunk(uint64_t id) const;
+
+    public:
+        static constexpr size_t kDefaultMemoryCap = 256 * 1024 * 1024;
+
+        LogEventStore(size_t memoryCap = kDefaultMemoryCap)
+            : mMemoryCap(memoryCap)
+        { }
+
+        void append(LogChunk chunk);
+
+        void clear();
+
+        void setMemoryCap(size_t bytes);
+        size_t getMemoryCap() const { return mMemoryCap; }
+        size_t getMemoryUsage() const { return mMemoryUsage; }
+
+        /// @brief Number of events currently retained.
+        size_t size() const { return static_cast<size_t>(mEndEvent - mFirstEvent); }
+        bool empty() const { return mFirstEvent == mEndEvent; }
+
+        /// @brief Number of events dropped from the front since the last clear.
+        uint64_t getEvictedCount() const { return mFirstEvent; }
+
+        LogEventView at(size_t i) const;
+
+        /// @brief Share every chunk holding events with an id of @p from or
+        ///        later. Ids count from the first event since the last clear.
+        void share(uint64_t from, std::vector<SharedLogChunk>& out) const;
+    };
+}
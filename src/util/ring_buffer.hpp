@@ -0,0 +1,71 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+
+namespace sm {
+    //
+    // Bounded single producer, single consumer queue. Pushing never blocks
+    // or allocates, a full buffer rejects the item and leaves it to the
+    // producer to decide what to drop.
+    //
+    // The capacity is rounded up to a power of two so indices wrap with a
+    // mask. Head and tail are on separate cache lines, each written by
+    // only one side.
+    //
+    template<typename T>
+    class RingBuffer {
+        static constexpr size_t kCacheLine = 64;
+
+        std::unique_ptr<T[]> mSlots;
+        size_t mMask;
+
+        alignas(kCacheLine) std::atomic<size_t> mHead{0}; // next slot to pop, written by the consumer
+        alignas(kCacheLine) std::atomic<size_t> mTail{0}; // next slot to push, written by the producer
+
+    public:
+        explicit RingBuffer(size_t capacity)
+            : mSlots(std::make_unique<T[]>(std::bit_ceil(std::max<size_t>(capacity, 1))))
+            , mMask(std::bit_ceil(std::max<size_t>(capacity, 1)) - 1)
+        { }
+
+        RingBuffer(const RingBuffer&) = delete;
+        RingBuffer& operator=(const RingBuffer&) = delete;
+
+        /// @brief Producer side. Leaves @p item untouched if the buffer is full.
+        /// @return False if the buffer is full.
+        bool tryPush(T& item) {
+            size_t tail = mTail.load(std::memory_order_relaxed);
+            if (tail - mHead.load(std::memory_order_acquire) > mMask) {
+                return false;
+            }
+
+            mSlots[tail & mMask] = std::move(item);
+            mTail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        /// @brief Consumer side.
+        /// @return False if the buffer is empty.
+        bool tryPop(T& item) {
+            size_t head = mHead.load(std::memory_order_relaxed);
+            if (head == mTail.load(std::memory_order_acquire)) {
+                return false;
+            }
+
+            item = std::move(mSlots[head & mMask]);
+            mHead.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        size_t getCapacity() const { return mMask + 1; }
+
+        /// @brief Approximate when called while the other side is active.
+        size_t size() const {
+            return mTail.load(std::memory_order_acquire) - mHead.load(std::memory_order_acquire);
+        }
+    };
+}
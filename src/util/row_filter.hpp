@@ -0,0 +1,97 @@
+#pragma once
+
+#include "util/sort_index.hpp"
+#include "util/trigram.hpp"
+
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace sm {
+    //
+    // Maps TrigramQuery matches onto table rows. Each row remembers the
+    // document id it was indexed under on the worker thread, rows may be
+    // drained in a different order than they were indexed.
+    //
+    class RowFilter {
+        std::shared_ptr<TrigramIndex> mIndex = std::make_shared<TrigramIndex>();
+        TrigramQuery mQuery;
+
+        // Document id to row index plus one, zero until the row is drained.
+        std::vector<uint32_t> mDocumentRows;
+        std::vector<uint8_t> mRowMatches;
+        size_t mRowCount = 0;
+
+    public:
+        /// @brief Start over with an empty index for a new fetch.
+        std::shared_ptr<TrigramIndex> reset() {
+            mIndex = std::make_shared<TrigramIndex>();
+            mQuery.clear();
+            mDocumentRows.clear();
+            mRowMatches.clear();
+            mRowCount = 0;
+            return mIndex;
+        }
+
+        const std::shared_ptr<TrigramIndex>& getIndex() const {
+            return mIndex;
+        }
+
+        /// @brief Catch up with newly drained rows and the current query.
+        /// @param getDocument Returns the document id a row was indexed under.
+        /// @return True if the set of matching rows may have changed.
+        template<typename R, typename F>
+        bool update(std::span<const R> rows, F&& getDocument, std::string_view query) {
+            if (rows.size() < mRowCount) {
+                mDocumentRows.clear();
+                mRowCount = 0;
+            }
+
+            bool rowsChanged = rows.size() != mRowCount;
+            for (size_t i = mRowCount; i < rows.size(); ++i) {
+                uint32_t document = getDocument(rows[i]);
+                if (document >= mDocumentRows.size()) {
+                    mDocumentRows.resize(document + 1, 0);
+                }
+
+                mDocumentRows[document] = static_cast<uint32_t>(i + 1);
+            }
+
+            mRowCount = rows.size();
+
+            bool queryChanged = mQuery.update(*mIndex, query);
+            if (!mQuery.isActive() || !(queryChanged || rowsChanged)) {
+                return queryChanged;
+            }
+
+            mRowMatches.assign(mRowCount, 0);
+            for (uint32_t document : mQuery.getMatches()) {
+                if (document < mDocumentRows.size() && mDocumentRows[document] != 0) {
+                    mRowMatches[mDocumentRows[document] - 1] = 1;
+                }
+            }
+
+            return true;
+        }
+
+        bool isActive() const {
+            return mQuery.isActive();
+        }
+
+        bool matches(uint32_t row) const {
+            return !isActive() || (row < mRowMatches.size() && mRowMatches[row]);
+        }
+
+        /// @brief Collect the matching rows in sorted order into @p out.
+        void apply(const SortIndex& order, bool descending, std::vector<uint32_t>& out) const {
+            out.clear();
+            for (size_t i = 0; i < order.size(); ++i) {
+                uint32_t row = order.at(i, descending);
+                if (matches(row)) {
+                    out.push_back(row);
+                }
+            }
+        }
+    };
+}
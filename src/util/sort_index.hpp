@@ -0,0 +1,73 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace sm {
+    //
+    // Permutation of row indices in ascending key order, kept up to date as
+    // rows are appended. Only the newly appended rows are sorted, they are
+    // then merged into the existing order, so keeping the index current costs
+    // O(n) per batch rather than a full O(n log n) resort.
+    //
+    class SortIndex {
+        std::vector<uint32_t> mOrder;
+
+    public:
+        /// @brief Bring the index up to date with rows [0, @p rowCount).
+        /// @param less Strict weak ordering over row indices, ties are broken
+        ///        by row index so the order is stable.
+        template<typename F>
+        void update(size_t rowCount, F&& less) {
+            size_t indexed = mOrder.size();
+            if (rowCount < indexed) {
+                mOrder.clear();
+                indexed = 0;
+            }
+
+            if (rowCount == indexed) {
+                return;
+            }
+
+            auto compare = [&](uint32_t lhs, uint32_t rhs) {
+                if (less(lhs, rhs)) {
+                    return true;
+                }
+
+                if (less(rhs, lhs)) {
+                    return false;
+                }
+
+                return lhs < rhs;
+            };
+
+            mOrder.reserve(rowCount);
+            for (size_t i = indexed; i < rowCount; ++i) {
+                mOrder.push_back(static_cast<uint32_t>(i));
+            }
+
+            auto middle = mOrder.begin() + indexed;
+            std::sort(middle, mOrder.end(), compare);
+            std::inplace_merge(mOrder.begin(), middle, mOrder.end(), compare);
+        }
+
+        void clear() {
+            mOrder.clear();
+        }
+
+        size_t size() const {
+            return mOrder.size();
+        }
+
+        /// @brief The row at position @p i of the ascending or descending order.
+        uint32_t at(size_t i, bool descending) const {
+            return descending ? mOrder[mOrder.size() - i - 1] : mOrder[i];
+        }
+
+        std::span<const uint32_t> getOrder() const {
+            return mOrder;
+        }
+    };
+}
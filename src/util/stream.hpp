@@ -1,8 +1,17 @@
 #pragma once
 
-#include <thread>
+#include "util/executor.hpp"
+
 #include <atomic>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
 #include <optional>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
 #include <concurrentqueue.h>
 
 namespace sm {
@@ -15,87 +24,356 @@ namespace sm {
     class AsyncStream {
         struct Entry {
             uint32_t generation;
-            T item;
+            std::vector<T> page;
         };
 
-        std::atomic<AsyncStreamState> mState;
-        uint32_t mGeneration;
+        static constexpr size_t kDefaultCapacity = 16;
 
-        std::unique_ptr<std::jthread> mWorkerThread;
-        moodycamel::ConcurrentQueue<Entry> mItemQueue;
+        //
+        // Shared between the stream and its workers, see AsyncDescribe::State.
+        //
+        struct State {
+            std::atomic<uint32_t> generation{0};
+            std::atomic<uint32_t> completed{0};
+            moodycamel::ConcurrentQueue<Entry> queue;
 
-        std::atomic<bool> mHasError{false};
-        std::optional<E> mLastError;
+            std::mutex capacityMutex;
+            std::condition_variable_any capacityChanged;
+            size_t queuedPages{0};
+            size_t capacity{kDefaultCapacity};
+            std::function<void()> parked; // resumes a crawl waiting for room
 
-        void reset() {
-            mHasError.store(false);
-            mLastError.reset();
-            if (mWorkerThread) {
-                mWorkerThread->request_stop();
+            std::mutex errorMutex;
+            std::optional<E> error;
+            std::atomic<bool> hasError{false};
+
+            bool isCurrent(uint32_t gen) const {
+                return generation.load() == gen;
+            }
+
+            void complete(uint32_t gen) {
+                uint32_t prev = completed.load();
+                while (prev < gen && !completed.compare_exchange_weak(prev, gen)) { }
+            }
+
+            void fail(uint32_t gen, E err) {
+                if (!isCurrent(gen)) {
+                    return;
+                }
+
+                std::lock_guard lock(errorMutex);
+                error = std::move(err);
+                hasError.store(true);
+            }
+
+            //
+            // With `wait` set, blocks the producer while the consumer is
+            // `capacity` pages behind. Returns false if the producer was
+            // stopped while waiting. A crawl never waits here, it parks
+            // between pages instead.
+            //
+            bool push(uint32_t gen, std::vector<T> page, std::stop_token stop, bool wait) {
+                if (page.empty()) {
+                    return !stop.stop_requested();
+                }
+
+                {
+                    std::unique_lock lock(capacityMutex);
+                    if (wait && !capacityChanged.wait(lock, stop, [this] { return queuedPages < capacity; })) {
+                        return false;
+                    }
+
+                    queuedPages += 1;
+                }
+
+                queue.enqueue({gen, std::move(page)});
+                return true;
+            }
+
+            //
+            // Keeps @p resume to be called once the consumer makes room.
+            // Returns false, without keeping it, if there is room already or
+            // the producer was stopped. cancel() and reset() request the stop
+            // before dropping what is parked, so checking under the lock
+            // means a stopped crawl is never left holding its own State.
+            //
+            bool park(uint32_t gen, std::stop_token stop, std::function<void()> resume) {
+                std::lock_guard lock(capacityMutex);
+                if (stop.stop_requested() || !isCurrent(gen) || queuedPages < capacity) {
+                    return false;
+                }
+
+                parked = std::move(resume);
+                return true;
+            }
+
+            // Called with capacityMutex held, the caller runs the result after unlocking.
+            std::function<void()> takeParked() {
+                std::function<void()> resume;
+                if (queuedPages < capacity) {
+                    resume = std::exchange(parked, nullptr);
+                }
+                return resume;
             }
+
+            void dropParked() {
+                std::lock_guard lock(capacityMutex);
+                parked = nullptr;
+            }
+
+            void release() {
+                std::function<void()> resume;
+                {
+                    std::lock_guard lock(capacityMutex);
+                    queuedPages -= 1;
+                    resume = takeParked();
+                }
+
+                capacityChanged.notify_one();
+
+                if (resume) {
+                    resume();
+                }
+            }
+        };
+
+        //
+        // Handed to the producer as its `add` callback. Accepts either a single
+        // item or a whole page of items, pages are delivered to the consumer
+        // as one unit.
+        //
+        class Sink {
+            State *mState;
+            uint32_t mGeneration;
+            std::stop_token mStop;
+            bool mWait;
+
+        public:
+            Sink(State *state, uint32_t generation, std::stop_token stop, bool wait)
+                : mState(state)
+                , mGeneration(generation)
+                , mStop(std::move(stop))
+                , mWait(wait)
+            { }
+
+            bool operator()(T item) const {
+                std::vector<T> page;
+                page.push_back(std::move(item));
+                return mState->push(mGeneration, std::move(page), mStop, mWait);
+            }
+
+            template<std::ranges::input_range R>
+                requires (!std::same_as<std::remove_cvref_t<R>, T>)
+            bool operator()(R&& range) const {
+                std::vector<T> page;
+                if constexpr (std::ranges::sized_range<R>) {
+                    page.reserve(std::ranges::size(range));
+                }
+
+                if constexpr (std::is_rvalue_reference_v<R&&>) {
+                    for (auto& item : range) {
+                        page.push_back(std::move(item));
+                    }
+                } else {
+                    page.insert(page.end(), std::ranges::begin(range), std::ranges::end(range));
+                }
+
+                return mState->push(mGeneration, std::move(page), mStop, mWait);
+            }
+        };
+
+        std::shared_ptr<State> mShared;
+
+        std::vector<T> mCurrentPage;
+        size_t mCurrentIndex{0};
+
+        TaskHandle mTask;
+
+        void reset() {
+            clear();
+            mCurrentPage.clear();
+            mCurrentIndex = 0;
+            mTask.requestStop();
+            mShared->dropParked();
         }
 
     public:
         AsyncStream()
-            : mState(AsyncStreamState::eIdle)
-            , mGeneration(0)
+            : mShared(std::make_shared<State>())
         { }
 
+        ~AsyncStream() {
+            cancel();
+        }
+
         bool isWorking() const {
-            return mState.load() == AsyncStreamState::eStreaming;
+            return mShared->completed.load() != mShared->generation.load();
         }
 
         bool hasError() const {
-            return mHasError.load();
+            return mShared->hasError.load();
         }
 
         E error() const {
             assert(hasError());
-            return mLastError.value();
+            std::lock_guard lock(mShared->errorMutex);
+            return mShared->error.value();
         }
 
-        std::optional<T> pullItem() {
+        /// @brief Set how many undelivered pages may be queued before the
+        ///        producer is paused.
+        void setCapacity(size_t pages) {
+            std::function<void()> resume;
+            {
+                std::lock_guard lock(mShared->capacityMutex);
+                mShared->capacity = std::max<size_t>(pages, 1);
+                resume = mShared->takeParked();
+            }
+
+            mShared->capacityChanged.notify_all();
+
+            if (resume) {
+                resume();
+            }
+        }
+
+        size_t getQueuedPageCount() {
+            std::lock_guard lock(mShared->capacityMutex);
+            return mShared->queuedPages;
+        }
+
+        std::optional<std::vector<T>> pullPage() {
+            if (mCurrentIndex < mCurrentPage.size()) {
+                std::vector<T> rest(std::make_move_iterator(mCurrentPage.begin() + mCurrentIndex), std::make_move_iterator(mCurrentPage.end()));
+                mCurrentPage.clear();
+                mCurrentIndex = 0;
+                return rest;
+            }
+
+            uint32_t generation = mShared->generation.load();
+
             Entry entry;
-            if (mItemQueue.try_dequeue(entry)) {
-                if (entry.generation == mGeneration) {
-                    return entry.item;
+            while (mShared->queue.try_dequeue(entry)) {
+                mShared->release();
+
+                if (entry.generation == generation) {
+                    return std::move(entry.page);
                 }
             }
 
             return std::nullopt;
         }
 
-        void fail(E error) {
-            mLastError = std::move(error);
-            mHasError.store(true);
+        std::optional<T> pullItem() {
+            if (mCurrentIndex >= mCurrentPage.size()) {
+                auto page = pullPage();
+                if (!page.has_value()) {
+                    return std::nullopt;
+                }
+
+                mCurrentPage = std::move(*page);
+                mCurrentIndex = 0;
+            }
+
+            return std::move(mCurrentPage[mCurrentIndex++]);
         }
 
         void clear() {
-            mHasError.store(false);
-            mLastError.reset();
+            std::lock_guard lock(mShared->errorMutex);
+            mShared->hasError.store(false);
+            mShared->error.reset();
+        }
+
+        /// @brief Stop the current producer without waiting for it.
+        ///        Pages it has not delivered yet are dropped.
+        void cancel() {
+            mTask.requestStop();
+            mShared->dropParked();
+            mShared->complete(mShared->generation.fetch_add(1) + 1);
         }
 
         template<typename F>
         void run(F&& fn) {
             reset();
 
-            mWorkerThread.reset(new std::jthread([this, fn = std::forward<F>(fn)](std::stop_token stop) {
-                mState = AsyncStreamState::eStreaming;
-
-                auto generation = ++mGeneration;
+            auto generation = mShared->generation.fetch_add(1) + 1;
 
-                auto add = [this, generation](T item) {
-                    mItemQueue.enqueue({generation, std::move(item)});
-                };
+            mTask = Executor::get().submit([shared = mShared, generation, fn = std::forward<F>(fn)](std::stop_token stop) {
+                Sink add{shared.get(), generation, stop, true};
 
-                auto err = [this](E error) {
-                    fail(std::move(error));
+                auto err = [&shared, generation](E error) {
+                    shared->fail(generation, std::move(error));
                 };
 
                 fn(add, err, stop);
 
-                mState = AsyncStreamState::eIdle;
-            }));
+                shared->complete(generation);
+            });
+        }
+
+        /// @brief Stream a paginated resource one page per executor task,
+        ///        see AsyncDescribe::crawl.
+        ///
+        /// Once `capacity` pages are waiting for the consumer the crawl is
+        /// parked rather than blocking a worker. The chain ends and is
+        /// started again, with the same stop source, when a page is pulled.
+        template<typename G, typename F>
+        void crawl(G&& makePages, F&& onPage) {
+            using Pages = std::invoke_result_t<std::decay_t<G>&, std::stop_token>;
+
+            struct Crawl {
+                std::shared_ptr<State> shared;
+                uint32_t generation;
+                std::decay_t<G> makePages;
+                std::decay_t<F> onPage;
+                std::optional<Pages> pages;
+
+                bool operator()(std::stop_token stop) {
+                    if (!pages.has_value()) {
+                        pages.emplace(makePages(stop));
+                    }
+
+                    if (!shared->isCurrent(generation) || !pages->next()) {
+                        shared->complete(generation);
+                        return false;
+                    }
+
+                    Sink add{shared.get(), generation, stop, false};
+
+                    auto err = [this](E error) {
+                        shared->fail(generation, std::move(error));
+                    };
+
+                    onPage(pages->value(), add, err);
+                    return true;
+                }
+            };
+
+            struct CrawlStep {
+                std::stop_source source;
+                std::shared_ptr<Crawl> crawl;
+
+                bool operator()(std::stop_token stop) const {
+                    if (!(*crawl)(stop)) {
+                        return false;
+                    }
+
+                    // The State holds the step while parked, cancel() and reset() let go of it.
+                    bool isParked = crawl->shared->park(crawl->generation, stop, [step = *this] {
+                        Executor::get().submitSteps(step.source, step);
+                    });
+
+                    return !isParked && !stop.stop_requested();
+                }
+            };
+
+            reset();
+
+            auto generation = mShared->generation.fetch_add(1) + 1;
+
+            std::stop_source source;
+            auto crawl = std::make_shared<Crawl>(Crawl{mShared, generation, std::forward<G>(makePages), std::forward<F>(onPage), std::nullopt});
+            mTask = Executor::get().submitSteps(source, CrawlStep{source, std::move(crawl)});
         }
     };
-}
\ No newline at end of file
+}
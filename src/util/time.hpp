@@ -0,0 +1,14 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <format>
+#include <string>
+
+namespace sm {
+    /// @brief Format a unix epoch millisecond timestamp as UTC for display.
+    inline std::string formatEpochMs(int64_t epochMs) {
+        std::chrono::system_clock::time_point tp{std::chrono::milliseconds{epochMs}};
+        return std::format("{0:%Y}-{0:%m}-{0:%d}:{0:%H}:{0:%M}:{0:%S}", tp);
+    }
+}
@@ -0,0 +1,100 @@
+#include "time_series.hpp"
+
+#include <algorithm>
+
+using sm::TimeSeries;
+using sm::TimeSeriesStore;
+
+bool TimeSeries::append(int64_t timestamp, double value) {
+    if (mSize > 0) {
+        int64_t last = getTimestamp(mSize - 1);
+        if (timestamp < last) {
+            return false;
+        }
+
+        if (timestamp == last) {
+            mBlocks[(mSize - 1) / kBlockSize]->values[(mSize - 1) % kBlockSize] = value;
+            mVersion += 1;
+            return true;
+        }
+    }
+
+    if (mSize == mBlocks.size() * kBlockSize) {
+        mBlocks.push_back(std::make_unique<Block>());
+    }
+
+    Block& block = *mBlocks[mSize / kBlockSize];
+    block.timestamps[mSize % kBlockSize] = timestamp;
+    block.values[mSize % kBlockSize] = value;
+    mSize += 1;
+    return true;
+}
+
+void TimeSeries::clear() {
+    mBlocks.clear();
+    mSize = 0;
+    mVersion += 1;
+}
+
+sm::TimeSeriesRange TimeSeries::slice(int64_t from, int64_t to) const {
+    auto lowerBound = [&](int64_t timestamp) {
+        //
+        // Find the block first by its leading timestamp, then search
+        // within that one block's column.
+        //
+        auto block = std::partition_point(mBlocks.begin(), mBlocks.end(), [&](const auto& it) {
+            return it->timestamps[0] < timestamp;
+        });
+
+        if (block == mBlocks.begin()) {
+            return size_t(0);
+        }
+
+        size_t index = static_cast<size_t>(block - mBlocks.begin()) - 1;
+        size_t count = std::min(kBlockSize, mSize - index * kBlockSize);
+        const int64_t *timestamps = mBlocks[index]->timestamps;
+        return index * kBlockSize + static_cast<size_t>(std::lower_bound(timestamps, timestamps + count, timestamp) - timestamps);
+    };
+
+    size_t first = lowerBound(from);
+    size_t last = std::max(first, lowerBound(to));
+    return TimeSeriesRange{first, last - first};
+}
+
+std::pair<double, double> TimeSeries::getValueBounds(TimeSeriesRange range) const {
+    double low = getValue(range.first);
+    double high = low;
+
+    size_t end = range.first + range.count;
+    for (size_t block = range.first / kBlockSize; block * kBlockSize < end; ++block) {
+        size_t base = block * kBlockSize;
+        size_t first = std::max(range.first, base) - base;
+        size_t last = std::min(end, base + kBlockSize) - base;
+
+        const double *values = mBlocks[block]->values;
+        for (size_t i = first; i < last; ++i) {
+            low = std::min(low, values[i]);
+            high = std::max(high, values[i]);
+        }
+    }
+
+    return {low, high};
+}
+
+sm::SeriesId TimeSeriesStore::getOrCreate(std::string_view key) {
+    auto [it, isNew] = mIds.try_emplace(std::string{key}, static_cast<SeriesId>(mSeries.size()));
+    if (isNew) {
+        mSeries.emplace_back();
+        mKeys.emplace_back(key);
+    }
+
+    return it->second;
+}
+
+std::optional<sm::SeriesId> TimeSeriesStore::find(std::string_view key) const {
+    if (auto it = mIds.find(std::string{key}); it != mIds.end()) {
+        return it->second;
+    }
+
+    return std::nullopt;
+}
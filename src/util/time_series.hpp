@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace sm {
+    struct TimeSeriesRange {
+        size_t first;
+        size_t count;
+    };
+
+    //
+    // Points of one series in time order, int64 unix epoch milliseconds and
+    // double values. Points live in fixed size blocks, each holding a
+    // column of timestamps and a column of values, so appending never moves
+    // the points already stored and a range of either column is a plain
+    // array walk.
+    //
+    // Points are expected in time order. A point with the same timestamp as
+    // the last one replaces its value, CloudWatch revises the latest period
+    // while it is still filling. Older points are dropped.
+    //
+    class TimeSeries {
+    public:
+        static constexpr size_t kBlockSize = 1024;
+
+    private:
+        struct Block {
+            alignas(64) int64_t timestamps[kBlockSize];
+            alignas(64) double values[kBlockSize];
+        };
+
+        std::vector<std::unique_ptr<Block>> mBlocks;
+        size_t mSize = 0;
+        uint64_t mVersion = 0;
+
+    public:
+        /// @return True if the point was added or replaced the last one.
+        bool append(int64_t timestamp, double value);
+
+        void clear();
+
+        size_t size() const { return mSize; }
+        bool empty() const { return mSize == 0; }
+
+        /// @brief Bumped whenever points already stored change, appends only grow size().
+        uint64_t getVersion() const { return mVersion; }
+
+        int64_t getTimestamp(size_t index) const { return mBlocks[index / kBlockSize]->timestamps[index % kBlockSize]; }
+        double getValue(size_t index) const { return mBlocks[index / kBlockSize]->values[index % kBlockSize]; }
+
+        /// @brief Points with timestamps in [@p from, @p to).
+        TimeSeriesRange slice(int64_t from, int64_t to) const;
+
+        /// @brief Lowest and highest value in @p range, @p range must not be empty.
+        std::pair<double, double> getValueBounds(TimeSeriesRange range) const;
+    };
+
+    using SeriesId = uint32_t;
+
+    //
+    // Every series fetched in a session, named by a key that identifies
+    // what was measured. Views look series up by key so they share points
+    // with each other instead of each keeping their own copy.
+    //
+    class TimeSeriesStore {
+        std::unordered_map<std::string, SeriesId> mIds;
+        std::vector<TimeSeries> mSeries;
+        std::vector<std::string> mKeys;
+
+    public:
+        SeriesId getOrCreate(std::string_view key);
+        std::optional<SeriesId> find(std::string_view key) const;
+
+        TimeSeries& get(SeriesId id) { return mSeries[id]; }
+        const TimeSeries& get(SeriesId id) const { return mSeries[id]; }
+        const std::string& getKey(SeriesId id) const { return mKeys[id]; }
+
+        size_t size() const { return mSeries.size(); }
+    };
+}
@@ -0,0 +1,190 @@
+#include "trigram.hpp"
+
+#include <algorithm>
+#include <mutex>
+
+using sm::TrigramIndex;
+using sm::TrigramQuery;
+
+namespace {
+    char fold(char c) {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    uint32_t trigramAt(std::string_view text, size_t i) {
+        return (uint32_t(uint8_t(fold(text[i]))) << 16)
+             | (uint32_t(uint8_t(fold(text[i + 1]))) << 8)
+             | uint32_t(uint8_t(fold(text[i + 2])));
+    }
+
+    bool containsFolded(std::string_view text, std::string_view query) {
+        auto it = std::search(text.begin(), text.end(), query.begin(), query.end(), [](char lhs, char rhs) {
+            return fold(lhs) == rhs;
+        });
+
+        return it != text.end() || query.empty();
+    }
+}
+
+void TrigramIndex::addDocument(std::string_view text) {
+    uint32_t id = static_cast<uint32_t>(mDocuments.size());
+    mDocuments.push_back(text);
+
+    for (size_t i = 0; i + 3 <= text.size(); ++i) {
+        auto& postings = mPostings[trigramAt(text, i)];
+
+        // A trigram repeated within one document is only recorded once.
+        if (postings.empty() || postings.back() != id) {
+            postings.push_back(id);
+        }
+    }
+}
+
+uint32_t TrigramIndex::insert(std::span<const InternedString> texts) {
+    std::unique_lock lock(mMutex);
+
+    uint32_t first = static_cast<uint32_t>(mDocuments.size());
+    for (InternedString text : texts) {
+        addDocument(text.view());
+    }
+
+    return first;
+}
+
+uint32_t TrigramIndex::getDocumentCount() const {
+    std::shared_lock lock(mMutex);
+    return static_cast<uint32_t>(mDocuments.size());
+}
+
+void TrigramIndex::search(std::string_view query, uint32_t first, uint32_t last, std::vector<uint32_t>& out) const {
+    std::shared_lock lock(mMutex);
+
+    last = std::min(last, static_cast<uint32_t>(mDocuments.size()));
+    if (first >= last) {
+        return;
+    }
+
+    if (query.size() < 3) {
+        //
+        // Too short to have a trigram, every document in range is a candidate.
+        //
+        for (uint32_t id = first; id < last; ++id) {
+            if (containsFolded(mDocuments[id], query)) {
+                out.push_back(id);
+            }
+        }
+
+        return;
+    }
+
+    //
+    // Collect the slice of each posting list that falls in range, a query
+    // trigram that has never been seen means nothing can match.
+    //
+    std::vector<std::span<const uint32_t>> lists;
+    for (size_t i = 0; i + 3 <= query.size(); ++i) {
+        auto it = mPostings.find(trigramAt(query, i));
+        if (it == mPostings.end()) {
+            return;
+        }
+
+        const auto& postings = it->second;
+        auto begin = std::lower_bound(postings.begin(), postings.end(), first);
+        auto end = std::lower_bound(begin, postings.end(), last);
+        if (begin == end) {
+            return;
+        }
+
+        lists.emplace_back(begin, end);
+    }
+
+    std::sort(lists.begin(), lists.end(), [](auto lhs, auto rhs) {
+        return lhs.size() < rhs.size();
+    });
+
+    //
+    // Walk the shortest list and probe the others, each probe only moves
+    // forward so the cost is bounded by the shortest list times log of
+    // the longer ones.
+    //
+    std::vector<const uint32_t*> cursors;
+    cursors.reserve(lists.size());
+    for (auto list : lists) {
+        cursors.push_back(list.data());
+    }
+
+    for (uint32_t id : lists[0]) {
+        bool found = true;
+        for (size_t i = 1; i < lists.size(); ++i) {
+            const uint32_t *end = lists[i].data() + lists[i].size();
+            cursors[i] = std::lower_bound(cursors[i], end, id);
+            if (cursors[i] == end || *cursors[i] != id) {
+                found = false;
+                break;
+            }
+        }
+
+        if (found && containsFolded(mDocuments[id], query)) {
+            out.push_back(id);
+        }
+    }
+}
+
+void TrigramIndex::refine(std::string_view query, std::span<const uint32_t> candidates, std::vector<uint32_t>& out) const {
+    std::shared_lock lock(mMutex);
+
+    for (uint32_t id : candidates) {
+        if (containsFolded(mDocuments[id], query)) {
+            out.push_back(id);
+        }
+    }
+}
+
+std::string TrigramIndex::foldCase(std::string_view text) {
+    std::string result{text};
+    std::transform(result.begin(), result.end(), result.begin(), fold);
+    return result;
+}
+
+bool TrigramQuery::update(const TrigramIndex& index, std::string_view query) {
+    std::string folded = TrigramIndex::foldCase(query);
+    uint32_t count = index.getDocumentCount();
+
+    if (folded.empty()) {
+        if (mQuery.empty()) {
+            return false;
+        }
+
+        clear();
+        return true;
+    }
+
+    if (folded == mQuery) {
+        if (count == mDocumentCount) {
+            return false;
+        }
+
+        index.search(folded, mDocumentCount, count, mMatches);
+        mDocumentCount = count;
+        return true;
+    }
+
+    mScratch.clear();
+    if (!mQuery.empty() && folded.find(mQuery) != std::string::npos) {
+        index.refine(folded, mMatches, mScratch);
+        index.search(folded, mDocumentCount, count, mScratch);
+    } else {
+        index.search(folded, 0, count, mScratch);
+    }
+
+    std::swap(mMatches, mScratch);
+    mQuery = std::move(folded);
+    mDocumentCount = count;
+    return true;
+}
+
+void TrigramQuery::clear() {
+    mQuery.clear();
+    mDocumentCount = 0;
+    mMatches.clear();
+}
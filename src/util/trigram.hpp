@@ -0,0 +1,75 @@
+#pragma once
+
+#include "util/intern.hpp"
+
+#include <cstdint>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace sm {
+    //
+    // Case insensitive substring index over a growing set of documents.
+    // Documents are appended from worker threads while the UI thread
+    // searches, document text is not copied and must outlive the index.
+    //
+    // Each document is broken into overlapping three byte windows, every
+    // window keeps a posting list of the documents it appears in. A query
+    // intersects the posting lists of its own trigrams then confirms the
+    // survivors with a substring compare.
+    //
+    class TrigramIndex {
+        mutable std::shared_mutex mMutex;
+        std::vector<std::string_view> mDocuments;
+        std::unordered_map<uint32_t, std::vector<uint32_t>> mPostings;
+
+        void addDocument(std::string_view text);
+
+    public:
+        TrigramIndex() = default;
+
+        TrigramIndex(const TrigramIndex&) = delete;
+        TrigramIndex& operator=(const TrigramIndex&) = delete;
+
+        /// @brief Index a batch of documents.
+        /// @return The id of the first document, the rest follow sequentially.
+        uint32_t insert(std::span<const InternedString> texts);
+
+        uint32_t getDocumentCount() const;
+
+        /// @brief Append the ids of documents in [@p first, @p last) containing
+        ///        @p query to @p out in ascending order.
+        /// @param query Must already be folded with foldCase.
+        void search(std::string_view query, uint32_t first, uint32_t last, std::vector<uint32_t>& out) const;
+
+        /// @brief Append the ids from @p candidates that contain @p query to @p out.
+        void refine(std::string_view query, std::span<const uint32_t> candidates, std::vector<uint32_t>& out) const;
+
+        static std::string foldCase(std::string_view text);
+    };
+
+    //
+    // A query against a TrigramIndex that is updated as the user types.
+    // When the new query contains the old one the previous matches are a
+    // superset of the new matches, so only those are rechecked. Documents
+    // added since the last update are searched on their own.
+    //
+    class TrigramQuery {
+        std::string mQuery;
+        uint32_t mDocumentCount = 0;
+        std::vector<uint32_t> mMatches;
+        std::vector<uint32_t> mScratch;
+
+    public:
+        /// @return True if the matches may have changed.
+        bool update(const TrigramIndex& index, std::string_view query);
+
+        void clear();
+
+        bool isActive() const { return !mQuery.empty(); }
+        std::span<const uint32_t> getMatches() const { return mMatches; }
+    };
+}
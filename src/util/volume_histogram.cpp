@@ -0,0 +1,139 @@
+#include "volume_histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using sm::VolumeHistogram;
+
+namespace {
+    int64_t floorDiv(int64_t value, int64_t divisor) {
+        int64_t quotient = value / divisor;
+        return (value % divisor != 0 && (value < 0) != (divisor < 0)) ? quotient - 1 : quotient;
+    }
+}
+
+int64_t VolumeHistogram::getWidth(size_t level) {
+    int64_t width = 1;
+    for (size_t i = 0; i < level; ++i) {
+        width *= kFactor;
+    }
+    return width;
+}
+
+void VolumeHistogram::reserve(Level& level, int64_t first, int64_t last) {
+    if (level.empty()) {
+        level.first = first;
+        level.events.resize(static_cast<size_t>(last - first + 1), 0);
+        level.bytes.resize(level.events.size(), 0);
+        return;
+    }
+
+    // Events older than any seen before, rare outside of tailing.
+    if (first < level.first) {
+        size_t count = static_cast<size_t>(level.first - first);
+        level.events.insert(level.events.begin(), count, 0);
+        level.bytes.insert(level.bytes.begin(), count, 0);
+        level.first = first;
+    }
+
+    if (last >= level.end()) {
+        level.events.resize(static_cast<size_t>(last - level.first + 1), 0);
+        level.bytes.resize(level.events.size(), 0);
+    }
+}
+
+void VolumeHistogram::rebuild(size_t index, int64_t first, int64_t last) {
+    Level& level = mLevels[index];
+    const Level& below = mLevels[index - 1];
+
+    reserve(level, first, last);
+
+    for (int64_t bucket = first; bucket <= last; ++bucket) {
+        int64_t childBegin = std::max(bucket * kFactor, below.first);
+        int64_t childEnd = std::min((bucket + 1) * kFactor, below.end());
+
+        uint32_t events = 0;
+        uint64_t bytes = 0;
+        for (int64_t child = childBegin; child < childEnd; ++child) {
+            events += below.events[static_cast<size_t>(child - below.first)];
+            bytes += below.bytes[static_cast<size_t>(child - below.first)];
+        }
+
+        level.events[static_cast<size_t>(bucket - level.first)] = events;
+        level.bytes[static_cast<size_t>(bucket - level.first)] = bytes;
+    }
+}
+
+void VolumeHistogram::add(const LogChunk& chunk) {
+    if (chunk.empty()) {
+        return;
+    }
+
+    int64_t first = INT64_MAX;
+    int64_t last = INT64_MIN;
+    for (size_t i = 0; i < chunk.size(); ++i) {
+        int64_t second = floorDiv(chunk.getTimestamp(i), 1000);
+        first = std::min(first, second);
+        last = std::max(last, second);
+    }
+
+    Level& base = mLevels[0];
+    reserve(base, first, last);
+
+    for (size_t i = 0; i < chunk.size(); ++i) {
+        size_t bucket = static_cast<size_t>(floorDiv(chunk.getTimestamp(i), 1000) - base.first);
+        size_t size = chunk.getOffset(i + 1) - chunk.getOffset(i);
+        base.events[bucket] += 1;
+        base.bytes[bucket] += size;
+        mTotalBytes += size;
+    }
+
+    mTotalEvents += chunk.size();
+
+    for (size_t level = 1; level < kLevelCount; ++level) {
+        first = floorDiv(first, kFactor);
+        last = floorDiv(last, kFactor);
+        rebuild(level, first, last);
+    }
+}
+
+void VolumeHistogram::clear() {
+    for (Level& level : mLevels) {
+        level = Level{};
+    }
+    mTotalEvents = 0;
+    mTotalBytes = 0;
+}
+
+double VolumeHistogram::getStart() const {
+    return static_cast<double>(mLevels[0].first);
+}
+
+double VolumeHistogram::getEnd() const {
+    return static_cast<double>(mLevels[0].end());
+}
+
+sm::VolumeHistogramView VolumeHistogram::getView(double start, double end, size_t maxBuckets) const {
+    size_t index = 0;
+    while (index + 1 < kLevelCount && (end - start) / static_cast<double>(getWidth(index)) > static_cast<double>(maxBuckets)) {
+        index += 1;
+    }
+
+    const Level& level = mLevels[index];
+    double width = static_cast<double>(getWidth(index));
+
+    int64_t first = std::max(static_cast<int64_t>(std::floor(start / width)), level.first);
+    int64_t last = std::min(static_cast<int64_t>(std::ceil(end / width)), level.end());
+    if (level.empty() || first >= last) {
+        return VolumeHistogramView{nullptr, nullptr, 0, 0.0, width};
+    }
+
+    size_t offset = static_cast<size_t>(first - level.first);
+    return VolumeHistogramView {
+        .events = level.events.data() + offset,
+        .bytes = level.bytes.data() + offset,
+        .size = static_cast<size_t>(last - first),
+        .start = static_cast<double>(first) * width,
+        .width = width,
+    };
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "util/log_store.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace sm {
+    //
+    // A contiguous run of buckets of one level of a VolumeHistogram, read
+    // in place. Bucket i covers [start + i * width, start + (i + 1) * width)
+    // in unix epoch seconds.
+    //
+    struct VolumeHistogramView {
+        const uint32_t *events;
+        const uint64_t *bytes;
+        size_t size;
+        double start;
+        double width;
+    };
+
+    //
+    // Event and byte counts over time, kept at kLevelCount resolutions. The
+    // finest level has one second buckets and each level above is kFactor
+    // times coarser. Adding a chunk bins its events into the finest level,
+    // then recomputes only the buckets above that it touched.
+    //
+    // Drawing any time range reads a single level, the finest one with no
+    // more buckets in range than there are pixels to show them. Its cost
+    // depends on the plot width, not on how many events were counted.
+    //
+    // Each level is dense between the first and last buckets it has seen,
+    // indexed by absolute bucket number so the levels line up.
+    //
+    class VolumeHistogram {
+    public:
+        static constexpr size_t kLevelCount = 12;
+        static constexpr int64_t kFactor = 4;
+
+    private:
+        struct Level {
+            int64_t first = 0; // absolute index of bucket 0
+            std::vector<uint32_t> events;
+            std::vector<uint64_t> bytes;
+
+            bool empty() const { return events.empty(); }
+            int64_t end() const { return first + static_cast<int64_t>(events.size()); }
+        };
+
+        std::array<Level, kLevelCount> mLevels;
+        uint64_t mTotalEvents = 0;
+        uint64_t mTotalBytes = 0;
+
+        static int64_t getWidth(size_t level);
+        static void reserve(Level& level, int64_t first, int64_t last);
+        void rebuild(size_t level, int64_t first, int64_t last);
+
+    public:
+        void add(const LogChunk& chunk);
+        void clear();
+
+        bool empty() const { return mLevels[0].empty(); }
+
+        /// @brief Seconds covered by any bucket, empty() must be false.
+        double getStart() const;
+        double getEnd() const;
+
+        uint64_t getTotalEvents() const { return mTotalEvents; }
+        uint64_t getTotalBytes() const { return mTotalBytes; }
+
+        /// @brief The buckets of the finest level that covers [@p start, @p end)
+        ///        in at most @p maxBuckets buckets, clipped to the counted range.
+        VolumeHistogramView getView(double start, double end, size_t maxBuckets) const;
+    };
+}